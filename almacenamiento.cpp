@@ -1,309 +1,835 @@
-#include "almacenamiento.h"
-#include "variables.h"
-#include <EEPROM.h>
-
-// Inicialización del almacenamiento
-void initStorage() {
-  // No es necesario hacer nada aquí para ESP8266/ESP32
-  // EEPROM.begin() se llama en setup()
-}
-
-// Leer configuración de la EEPROM
-void readConfigFromEEPROM() {
-  // Cargar ID del dispositivo
-  config.deviceId = loadDeviceId();
-  sprintf(config.deviceIdStr, "%02X", config.deviceId);
-  
-  // Cargar nombre de empresa
-  loadCompanyName(config.nombre_empresa, sizeof(config.nombre_empresa));
-  
-  // Cargar modos de funcionamiento
-  config.modo_tcpip485 = EEPROM.read(ADDR_TCP_MODE);
-  config.modo_work = EEPROM.read(ADDR_WORK_MODE);
-  config.modo_display = EEPROM.read(ADDR_DISPLAY_MODE);
-  config.modo_QR_8_12 = EEPROM.read(ADDR_QR_MODE);
-  config.modo_clock = EEPROM.read(ADDR_CLOCK_MODE);
-  config.modo_sens_altura = EEPROM.read(ADDR_SENS_MODE);
-  
-  // Configuración por defecto para valores inválidos
-  if (config.deviceId > 99) config.deviceId = 0;
-  if (config.modo_tcpip485 > 9) config.modo_tcpip485 = 0;
-  if (config.modo_work > 9) config.modo_work = 0;
-  if (config.modo_display > 9) config.modo_display = 0;
-  if (config.modo_QR_8_12 > 9) config.modo_QR_8_12 = 0;
-  if (config.modo_clock > 9) config.modo_clock = 0;
-  if (config.modo_sens_altura > 9) config.modo_sens_altura = 0;
-  
-  // Deducir si es puerta de entrada
-  config.esPuertaEntrada = (config.modo_work != 4);
-}
-
-// Restablecer configuración a valores predeterminados
-void resetConfigToDefaults() {
-  config.deviceId = 0;
-  strcpy(config.deviceIdStr, "00");
-  strcpy(config.nombre_empresa, "OemAccess");
-  config.modo_tcpip485 = 0;
-  config.modo_work = 0;
-  config.modo_display = 0;
-  config.modo_QR_8_12 = 0;
-  config.modo_clock = 0;
-  config.modo_sens_altura = 0;
-  config.esPuertaEntrada = true;
-  
-  // Guardar en EEPROM
-  saveDeviceId(config.deviceId);
-  saveCompanyName(config.nombre_empresa);
-  saveTcpIpMode(config.modo_tcpip485);
-  saveWorkMode(config.modo_work);
-  saveDisplayMode(config.modo_display);
-  saveQRMode(config.modo_QR_8_12);
-  saveClockMode(config.modo_clock);
-  saveSensorMode(config.modo_sens_altura);
-}
-
-// Funciones específicas
-uint8_t loadRelayTimer(int relayNum) {
-  if (relayNum < 1 || relayNum > 5) return 5; // Valor predeterminado
-  
-  uint8_t time = EEPROM.read(ADDR_RELAY1_TIME + (relayNum - 1));
-  return (time > 0 && time < 100) ? time : 5; // Valor predeterminado si fuera de rango
-}
-
-uint8_t loadDeviceId() {
-  uint8_t id = EEPROM.read(ADDR_DEVICE_ID);
-  return (id <= 99) ? id : 0; // Valor predeterminado si fuera de rango
-}
-
-void saveDeviceId(uint8_t id) {
-  EEPROM.write(ADDR_DEVICE_ID, id);
-  #if defined(ESP8266) || defined(ESP32)
-    EEPROM.commit();
-  #endif
-}
-
-void loadCompanyName(char* name, size_t maxLen) {
-  uint8_t i;
-  for (i = 0; i < maxLen - 1; i++) {
-    char c = EEPROM.read(ADDR_NAME0 + i);
-    name[i] = c;
-    if (c == 0) break;
-  }
-  name[i] = 0; // Asegurar terminación null
-  
-  // Valor predeterminado si está vacío
-  if (name[0] == 0 || name[0] == 0xFF) {
-    strcpy(name, "OemAccess");
-  }
-}
-
-void saveCompanyName(const char* name) {
-  uint8_t i;
-  for (i = 0; i < 16 && name[i] != 0; i++) {
-    EEPROM.write(ADDR_NAME0 + i, name[i]);
-  }
-  EEPROM.write(ADDR_NAME0 + i, 0); // Terminar con null
-  #if defined(ESP8266) || defined(ESP32)
-    EEPROM.commit();
-  #endif
-}
-
-void saveTcpIpMode(uint8_t mode) {
-  EEPROM.write(ADDR_TCP_MODE, mode);
-  #if defined(ESP8266) || defined(ESP32)
-    EEPROM.commit();
-  #endif
-}
-
-void saveWorkMode(uint8_t mode) {
-  EEPROM.write(ADDR_WORK_MODE, mode);
-  #if defined(ESP8266) || defined(ESP32)
-    EEPROM.commit();
-  #endif
-}
-
-void saveDisplayMode(uint8_t mode) {
-  EEPROM.write(ADDR_DISPLAY_MODE, mode);
-  #if defined(ESP8266) || defined(ESP32)
-    EEPROM.commit();
-  #endif
-}
-
-void saveQRMode(uint8_t mode) {
-  EEPROM.write(ADDR_QR_MODE, mode);
-  #if defined(ESP8266) || defined(ESP32)
-    EEPROM.commit();
-  #endif
-}
-
-void saveClockMode(uint8_t mode) {
-  EEPROM.write(ADDR_CLOCK_MODE, mode);
-  #if defined(ESP8266) || defined(ESP32)
-    EEPROM.commit();
-  #endif
-}
-
-void saveSensorMode(uint8_t mode) {
-  EEPROM.write(ADDR_SENS_MODE, mode);
-  #if defined(ESP8266) || defined(ESP32)
-    EEPROM.commit();
-  #endif
-}
-
-// Cargar modos desde EEPROM
-uint8_t loadTcpIpMode() {
-  uint8_t mode = EEPROM.read(ADDR_TCP_MODE);
-  return (mode <= 9) ? mode : 0; // Valor predeterminado si fuera de rango
-}
-
-uint8_t loadWorkMode() {
-  uint8_t mode = EEPROM.read(ADDR_WORK_MODE);
-  return (mode <= 9) ? mode : 0; // Valor predeterminado si fuera de rango
-}
-
-uint8_t loadDisplayMode() {
-  uint8_t mode = EEPROM.read(ADDR_DISPLAY_MODE);
-  return (mode <= 9) ? mode : 0; // Valor predeterminado si fuera de rango
-}
-
-uint8_t loadQRMode() {
-  uint8_t mode = EEPROM.read(ADDR_QR_MODE);
-  return (mode <= 9) ? mode : 0; // Valor predeterminado si fuera de rango
-}
-
-uint8_t loadClockMode() {
-  uint8_t mode = EEPROM.read(ADDR_CLOCK_MODE);
-  return (mode <= 9) ? mode : 0; // Valor predeterminado si fuera de rango
-}
-
-uint8_t loadSensorMode() {
-  uint8_t mode = EEPROM.read(ADDR_SENS_MODE);
-  return (mode <= 9) ? mode : 0; // Valor predeterminado si fuera de rango
-}
-
-void saveRelayTimer(int relayNum, uint8_t time) {
-  if (relayNum < 1 || relayNum > 5) return; // Validación
-  
-  EEPROM.write(ADDR_RELAY1_TIME + (relayNum - 1), time);
-  #if defined(ESP8266) || defined(ESP32)
-    EEPROM.commit();
-  #endif
-}
-
-void saveSerialNumber(int index, uint8_t value) {
-  if (index < 0 || index > 4) return; // Validación
-  
-  EEPROM.write(ADDR_SN0 + index, value);
-  #if defined(ESP8266) || defined(ESP32)
-    EEPROM.commit();
-  #endif
-}
-
-uint8_t loadSerialNumber(int index) {
-  if (index < 0 || index > 4) return 0; // Validación
-  
-  return EEPROM.read(ADDR_SN0 + index);
-}
-
-// Funciones para tickets
-void saveTicketLine(int lineNum, const char* text) {
-  if (lineNum < 1 || lineNum > 4) return; // Validación
-  
-  int addr = ADDR_TICKET_LINEA1 + (lineNum - 1) * 16;
-  for (int i = 0; i < 16 && text[i] != 0; i++) {
-    EEPROM.write(addr + i, text[i]);
-  }
-  
-  #if defined(ESP8266) || defined(ESP32)
-    EEPROM.commit();
-  #endif
-}
-
-void loadTicketLine(int lineNum, char* text, size_t maxLen) {
-  if (lineNum < 1 || lineNum > 4) {
-    text[0] = 0;
-    return;
-  }
-  
-  int addr = ADDR_TICKET_LINEA1 + (lineNum - 1) * 16;
-  for (int i = 0; i < min(maxLen - 1, (size_t)16); i++) {
-    char c = EEPROM.read(addr + i);
-    text[i] = c;
-    if (c == 0) break;
-  }
-  
-  text[min(maxLen - 1, (size_t)16)] = 0; // Asegurar terminación null
-}
-
-void saveTicketCounter(uint32_t counter) {
-  // La unidad de mil se guarda por separado
-  uint8_t unidadMil = counter / 1000;
-  uint16_t resto = counter % 1000;
-  
-  EEPROM.write(ADDR_UNIDAD_MILES, unidadMil);
-  
-  char buffer[4];
-  sprintf(buffer, "%03d", resto);
-  
-  for (int i = 0; i < 3; i++) {
-    EEPROM.write(ADDR_TICKET_NUMBER + i, buffer[i]);
-  }
-  
-  #if defined(ESP8266) || defined(ESP32)
-    EEPROM.commit();
-  #endif
-}
-
-uint32_t loadTicketCounter() {
-  uint8_t unidadMil = EEPROM.read(ADDR_UNIDAD_MILES);
-  
-  char buffer[4];
-  for (int i = 0; i < 3; i++) {
-    buffer[i] = EEPROM.read(ADDR_TICKET_NUMBER + i);
-  }
-  buffer[3] = 0;
-  
-  uint16_t resto = atoi(buffer);
-  
-  return unidadMil * 1000 + resto;
-}
-
-// Funciones EEPROM básicas
-uint8_t readEEPROM(int address) {
-  return EEPROM.read(address);
-}
-
-void writeEEPROM(int address, uint8_t value) {
-  EEPROM.write(address, value);
-  #if defined(ESP8266) || defined(ESP32)
-    EEPROM.commit();
-  #endif
-}
-
-void writeEEPROMBlock(int address, const uint8_t* data, size_t len) {
-  for (size_t i = 0; i < len; i++) {
-    EEPROM.write(address + i, data[i]);
-  }
-  
-  #if defined(ESP8266) || defined(ESP32)
-    EEPROM.commit();
-  #endif
-}
-
-void readEEPROMBlock(int address, uint8_t* data, size_t len) {
-  for (size_t i = 0; i < len; i++) {
-    data[i] = EEPROM.read(address + i);
-  }
-}
-
-// Escritura de configuración completa
-void writeConfigToEEPROM() {
-  saveDeviceId(config.deviceId);
-  saveCompanyName(config.nombre_empresa);
-  saveTcpIpMode(config.modo_tcpip485);
-  saveWorkMode(config.modo_work);
-  saveDisplayMode(config.modo_display);
-  saveQRMode(config.modo_QR_8_12);
-  saveClockMode(config.modo_clock);
-  saveSensorMode(config.modo_sens_altura);
-}
+#include "almacenamiento.h"
+#include "variables.h"
+#include "utilidades.h"
+#include <EEPROM.h>
+
+#ifdef ESP8266
+  #include <flash_hal.h>
+#elif defined(ESP32)
+  #include <esp_partition.h>
+  #include <freertos/FreeRTOS.h>
+  #include <freertos/task.h>
+  #include <freertos/semphr.h>
+#endif
+
+// Estado de la transacción de escritura
+// En ESP8266/ESP32 cada commit borra y reescribe un sector completo de flash,
+// por eso las escrituras se acumulan y se confirman una sola vez
+static uint8_t txDepth = 0;      // Nivel de anidamiento de transacciones abiertas
+static bool txDirty = false;     // Hay bytes modificados pendientes de commit
+static unsigned long lastWriteMs = 0; // Momento de la última modificación
+
+// Escritura diferida
+// Los save* solo modifican la copia en RAM de la EEPROM y responden enseguida;
+// el commit a flash lo hace una tarea de baja prioridad (ESP32) o storageLoop()
+// cuando el sistema está ocioso (ESP8266). syncStorage() fuerza el volcado.
+// En ESP32 storageMutex protege la copia en RAM y solo se retiene para copiarla
+// a commitEeprom; el commit graba esa segunda copia sin el mutex, así un save*
+// de la tarea de protocolo nunca espera el borrado y la escritura de flash.
+// commitMutex ordena los commits (tarea de escritura y syncStorage)
+#ifdef ESP32
+  static SemaphoreHandle_t storageMutex = NULL;
+  static SemaphoreHandle_t commitMutex = NULL;
+  static TaskHandle_t storageTask = NULL;
+  static EEPROMClass commitEeprom("eeprom");   // Mismo espacio NVS que EEPROM
+  
+  static void lockStorage() {
+    if (storageMutex != NULL) xSemaphoreTake(storageMutex, portMAX_DELAY);
+  }
+  
+  static void unlockStorage() {
+    if (storageMutex != NULL) xSemaphoreGive(storageMutex);
+  }
+  
+  static void lockCommit() {
+    if (commitMutex != NULL) xSemaphoreTake(commitMutex, portMAX_DELAY);
+  }
+  
+  static void unlockCommit() {
+    if (commitMutex != NULL) xSemaphoreGive(commitMutex);
+  }
+#else
+  static void lockStorage() {}
+  static void unlockStorage() {}
+#endif
+
+// Escribir un byte solo si cambia su valor (requiere lockStorage)
+static void storageWriteLocked(int address, uint8_t value) {
+  if (EEPROM.read(address) == value) return; // Sin cambios, no ensuciar
+  
+  EEPROM.write(address, value);
+  txDirty = true;
+  lastWriteMs = millis();
+}
+
+static void storageWrite(int address, uint8_t value) {
+  lockStorage();
+  storageWriteLocked(address, value);
+  unlockStorage();
+}
+
+// Volcar a flash los bytes modificados
+// force: también con una transacción abierta (syncStorage)
+#ifdef ESP32
+  // Se copia la EEPROM bajo storageMutex y se graba la copia fuera de él
+  static bool flushStorage(bool force) {
+    lockCommit();
+    lockStorage();
+    if (!txDirty || (!force && txDepth > 0)) {
+      unlockStorage();
+      unlockCommit();
+      return true;
+    }
+    
+    memcpy(commitEeprom.getDataPtr(), EEPROM.getDataPtr(), EEPROM.length());
+    txDirty = false;
+    unlockStorage();
+    
+    bool ok = commitEeprom.commit();
+    
+    lockStorage();
+    if (ok) {
+      metrics.storageCommits++;
+    } else {
+      txDirty = true; // Se reintenta en el próximo commit
+    }
+    unlockStorage();
+    
+    unlockCommit();
+    return ok;
+  }
+#else
+  static bool flushStorage(bool force) {
+    if (!txDirty || (!force && txDepth > 0)) return true;
+    
+    bool ok = true;
+    #ifdef ESP8266
+      ok = EEPROM.commit();
+    #endif
+    
+    if (ok) {
+      txDirty = false;
+      metrics.storageCommits++;
+    }
+    return ok;
+  }
+#endif
+
+// Programar el commit si no hay una transacción abierta
+static void storageAutoCommit() {
+  if (txDepth > 0 || !txDirty) return;
+  
+  #ifdef ESP32
+    if (storageTask != NULL) {
+      xTaskNotifyGive(storageTask);
+      return;
+    }
+    
+    // Sin tarea de escritura: confirmar en el momento
+    flushStorage(false);
+  #endif
+  // ESP8266: storageLoop() confirma cuando pasa STORAGE_FLUSH_DELAY_MS sin cambios
+}
+
+#ifdef ESP32
+  // Tarea de escritura: espera un aviso, deja pasar la ráfaga de cambios y confirma
+  static void storageWriterTask(void* param) {
+    for (;;) {
+      ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+      vTaskDelay(pdMS_TO_TICKS(STORAGE_FLUSH_DELAY_MS));
+      
+      flushStorage(false);
+    }
+  }
+#endif
+
+// Volcado diferido en ESP8266; llamar desde loop()
+void storageLoop() {
+  #ifndef ESP32
+    if (txDepth > 0 || !txDirty) return;
+    if (millis() - lastWriteMs < STORAGE_FLUSH_DELAY_MS) return;
+    
+    flushStorage(false);
+  #endif
+}
+
+// Confirmar ya todo lo pendiente (bloqueante)
+// Devuelve true cuando los datos están en flash
+bool syncStorage() {
+  return flushStorage(true);
+}
+
+// Abrir una transacción: los save* posteriores no programan commit
+void beginStorageTransaction() {
+  lockStorage();
+  txDepth++;
+  unlockStorage();
+}
+
+// Cerrar una transacción: la más externa programa un único commit
+bool commitStorageTransaction() {
+  lockStorage();
+  if (txDepth > 0) txDepth--;
+  unlockStorage();
+  
+  storageAutoCommit();
+  return true;
+}
+
+// Indica si hay cambios pendientes de confirmar
+bool isStorageDirty() {
+  return txDirty;
+}
+
+// Log del contador de tickets
+// Cada ticket agrega un registro de 12 bytes con CRC en sectores de flash
+// propios, sin borrar ni reescribir el sector de la EEPROM emulada. Al llenarse
+// un sector se pasa al siguiente (rotando) y se escribe allí el valor vigente,
+// que es lo único que hace falta conservar. Al arrancar se toma el registro
+// válido con mayor secuencia; un registro a medio escribir falla el CRC.
+#define TICKET_LOG_RECORDS (TICKET_LOG_SECTOR_SIZE / sizeof(TicketLogRecord))
+
+static struct {
+  bool available;                // Hay región de flash para el log
+  bool valid;                    // Se encontró (o grabó) al menos un registro
+  uint32_t base;                 // Inicio de la región (dirección u offset)
+  uint8_t sector;                // Sector activo
+  uint16_t slot;                 // Próximo registro libre del sector activo
+  uint32_t sequence;             // Secuencia del último registro válido
+  uint32_t counter;              // Último valor grabado
+} ticketLog;
+
+#ifdef ESP8266
+  // La región se toma del final del área FS (el proyecto no usa sistema de archivos)
+  // Requiere un esquema de flash con FS de al menos TICKET_LOG_SECTORS sectores
+  static bool flashLogInit() {
+    if (FS_PHYS_SIZE < TICKET_LOG_SECTORS * TICKET_LOG_SECTOR_SIZE) return false;
+    ticketLog.base = FS_PHYS_ADDR + FS_PHYS_SIZE - TICKET_LOG_SECTORS * TICKET_LOG_SECTOR_SIZE;
+    return true;
+  }
+  
+  static bool flashLogRead(uint32_t offset, TicketLogRecord* record) {
+    return ESP.flashRead(ticketLog.base + offset, (uint32_t*)record, sizeof(TicketLogRecord));
+  }
+  
+  static bool flashLogWrite(uint32_t offset, const TicketLogRecord* record) {
+    return ESP.flashWrite(ticketLog.base + offset, (uint32_t*)record, sizeof(TicketLogRecord));
+  }
+  
+  static bool flashLogErase(uint8_t sector) {
+    return ESP.flashEraseSector((ticketLog.base / TICKET_LOG_SECTOR_SIZE) + sector);
+  }
+#elif defined(ESP32)
+  // La región se toma del final de la partición de datos SPIFFS
+  static const esp_partition_t* ticketLogPartition = NULL;
+  
+  static bool flashLogInit() {
+    ticketLogPartition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_SPIFFS, NULL);
+    if (ticketLogPartition == NULL) return false;
+    if (ticketLogPartition->size < TICKET_LOG_SECTORS * TICKET_LOG_SECTOR_SIZE) return false;
+    ticketLog.base = ticketLogPartition->size - TICKET_LOG_SECTORS * TICKET_LOG_SECTOR_SIZE;
+    return true;
+  }
+  
+  static bool flashLogRead(uint32_t offset, TicketLogRecord* record) {
+    return esp_partition_read(ticketLogPartition, ticketLog.base + offset, record, sizeof(TicketLogRecord)) == ESP_OK;
+  }
+  
+  static bool flashLogWrite(uint32_t offset, const TicketLogRecord* record) {
+    return esp_partition_write(ticketLogPartition, ticketLog.base + offset, record, sizeof(TicketLogRecord)) == ESP_OK;
+  }
+  
+  static bool flashLogErase(uint8_t sector) {
+    return esp_partition_erase_range(ticketLogPartition, ticketLog.base + sector * TICKET_LOG_SECTOR_SIZE, TICKET_LOG_SECTOR_SIZE) == ESP_OK;
+  }
+#else
+  static bool flashLogInit() { return false; }
+  static bool flashLogRead(uint32_t, TicketLogRecord*) { return false; }
+  static bool flashLogWrite(uint32_t, const TicketLogRecord*) { return false; }
+  static bool flashLogErase(uint8_t) { return false; }
+#endif
+
+static uint32_t ticketLogOffset(uint8_t sector, uint16_t slot) {
+  return (uint32_t)sector * TICKET_LOG_SECTOR_SIZE + (uint32_t)slot * sizeof(TicketLogRecord);
+}
+
+static uint16_t ticketLogCrc(const TicketLogRecord* record) {
+  return crc16((const uint8_t*)record, offsetof(TicketLogRecord, crc));
+}
+
+static bool isTicketLogErased(const TicketLogRecord* record) {
+  return record->sequence == 0xFFFFFFFF && record->counter == 0xFFFFFFFF &&
+         record->crc == 0xFFFF && record->marker == 0xFFFF;
+}
+
+// Recorrer todos los sectores buscando el registro válido más reciente
+static void scanTicketLog() {
+  uint16_t usedSlots[TICKET_LOG_SECTORS];
+  
+  ticketLog.valid = false;
+  
+  for (uint8_t sector = 0; sector < TICKET_LOG_SECTORS; sector++) {
+    usedSlots[sector] = 0;
+    
+    for (uint16_t slot = 0; slot < TICKET_LOG_RECORDS; slot++) {
+      TicketLogRecord record;
+      if (!flashLogRead(ticketLogOffset(sector, slot), &record)) break;
+      if (isTicketLogErased(&record)) break; // Resto del sector sin usar
+      
+      usedSlots[sector] = slot + 1;
+      
+      // Registro incompleto o dañado: se ignora
+      if (record.marker != TICKET_LOG_MARKER || record.crc != ticketLogCrc(&record)) continue;
+      
+      if (!ticketLog.valid || record.sequence > ticketLog.sequence) {
+        ticketLog.valid = true;
+        ticketLog.sequence = record.sequence;
+        ticketLog.counter = record.counter;
+        ticketLog.sector = sector;
+      }
+    }
+  }
+  
+  if (ticketLog.valid) {
+    ticketLog.slot = usedSlots[ticketLog.sector];
+  } else {
+    // Log vacío: forzar borrado del primer sector en la primera escritura
+    ticketLog.sequence = 0;
+    ticketLog.sector = TICKET_LOG_SECTORS - 1;
+    ticketLog.slot = TICKET_LOG_RECORDS;
+  }
+}
+
+// Agregar un registro; al llenarse el sector se compacta en el siguiente
+static bool appendTicketLog(uint32_t counter) {
+  if (ticketLog.slot >= TICKET_LOG_RECORDS) {
+    ticketLog.sector = (ticketLog.sector + 1) % TICKET_LOG_SECTORS;
+    ticketLog.slot = 0;
+    if (!flashLogErase(ticketLog.sector)) return false;
+  }
+  
+  TicketLogRecord record;
+  record.sequence = ticketLog.sequence + 1;
+  record.counter = counter;
+  record.crc = ticketLogCrc(&record);
+  record.marker = TICKET_LOG_MARKER;
+  
+  // El espacio se consume aunque la escritura falle (pudo quedar a medias)
+  bool ok = flashLogWrite(ticketLogOffset(ticketLog.sector, ticketLog.slot), &record);
+  ticketLog.slot++;
+  
+  if (ok) {
+    ticketLog.valid = true;
+    ticketLog.sequence = record.sequence;
+    ticketLog.counter = counter;
+  }
+  
+  return ok;
+}
+
+static bool loadLegacyTicketCounter(uint32_t* counter);
+static void ensureConfigBlock();
+
+// Inicialización del almacenamiento
+// Debe llamarse después de EEPROM.begin() en setup()
+void initStorage() {
+  #ifdef ESP32
+    // Tarea de escritura en flash con prioridad mínima, fuera del loop
+    commitEeprom.begin(EEPROM.length());
+    storageMutex = xSemaphoreCreateMutex();
+    commitMutex = xSemaphoreCreateMutex();
+    xTaskCreatePinnedToCore(storageWriterTask, "storage", 4096, NULL, tskIDLE_PRIORITY + 1, &storageTask, 0);
+  #endif
+  
+  ensureConfigBlock();
+  
+  ticketLog.available = flashLogInit();
+  if (!ticketLog.available) return;
+  
+  scanTicketLog();
+  
+  // Primera vez con log: migrar el contador del formato heredado
+  uint32_t legacyCounter;
+  if (!ticketLog.valid && loadLegacyTicketCounter(&legacyCounter)) {
+    appendTicketLog(legacyCounter);
+  }
+}
+
+// Bloque de configuración
+// Toda la configuración persistente vive en un único ConfigBlock con versión
+// y CRC. Se lee de una vez al arrancar y se mantiene una copia en RAM; los
+// save* modifican la copia y escriben solo los bytes que cambiaron.
+static ConfigBlock configBlock;
+static bool configBlockLoaded = false;
+
+static uint16_t configBlockCrc(const ConfigBlock* block) {
+  return crc16((const uint8_t*)block, offsetof(ConfigBlock, crc));
+}
+
+// Valores predeterminados (los números de serie se conservan)
+static void setConfigBlockDefaults(ConfigBlock* block) {
+  block->deviceId = 0;
+  memset(block->nombre_empresa, 0, sizeof(block->nombre_empresa));
+  strcpy(block->nombre_empresa, "OemAccess");
+  block->modo_tcpip485 = 0;
+  block->modo_work = 0;
+  block->modo_display = 0;
+  block->modo_QR_8_12 = 0;
+  block->modo_clock = 0;
+  block->modo_sens_altura = 0;
+  
+  for (int i = 0; i < 5; i++) {
+    block->relayTime[i] = 5;
+  }
+  
+  block->ddmmTime[0] = 10; // Presencia DDMM1
+  block->ddmmTime[1] = 10; // Ausencia DDMM1
+  block->ddmmTime[2] = 10; // Presencia DDMM2
+  block->ddmmTime[3] = 10; // Ausencia DDMM2
+  
+  for (int i = 0; i < 4; i++) {
+    memset(block->ticketLine[i], 0, sizeof(block->ticketLine[i]));
+    sprintf(block->ticketLine[i], "Ticket Linea %d", i + 1);
+  }
+}
+
+// Migración desde el esquema heredado de direcciones ADDR_* sueltas
+static void migrateLegacyConfig(ConfigBlock* block) {
+  setConfigBlockDefaults(block);
+  
+  uint8_t id = EEPROM.read(ADDR_DEVICE_ID);
+  block->deviceId = (id <= 99) ? id : 0;
+  
+  char c = EEPROM.read(ADDR_NAME0);
+  if (c != 0 && (uint8_t)c != 0xFF) {
+    for (int i = 0; i < 16; i++) {
+      block->nombre_empresa[i] = EEPROM.read(ADDR_NAME0 + i);
+      if (block->nombre_empresa[i] == 0) break;
+    }
+    block->nombre_empresa[16] = 0;
+  }
+  
+  uint8_t* modes[] = {
+    &block->modo_tcpip485, &block->modo_work, &block->modo_display,
+    &block->modo_QR_8_12, &block->modo_clock, &block->modo_sens_altura
+  };
+  for (int i = 0; i < 6; i++) {
+    uint8_t mode = EEPROM.read(ADDR_TCP_MODE + i);
+    *modes[i] = (mode <= 9) ? mode : 0;
+  }
+  
+  for (int i = 0; i < 5; i++) {
+    uint8_t time = EEPROM.read(ADDR_RELAY1_TIME + i);
+    block->relayTime[i] = (time > 0 && time < 100) ? time : 5;
+  }
+  
+  for (int i = 0; i < 4; i++) {
+    uint8_t time = EEPROM.read(ADDR_DDMM1_PRESENT + i);
+    if (time < 100) block->ddmmTime[i] = time;
+  }
+  
+  for (int line = 0; line < 4; line++) {
+    int addr = ADDR_TICKET_LINEA1 + line * 16;
+    c = EEPROM.read(addr);
+    if (c == 0 || (uint8_t)c == 0xFF) continue;
+    
+    for (int i = 0; i < 16; i++) {
+      block->ticketLine[line][i] = EEPROM.read(addr + i);
+      if (block->ticketLine[line][i] == 0) break;
+    }
+    block->ticketLine[line][16] = 0;
+  }
+  
+  for (int i = 0; i < 5; i++) {
+    block->serialNumber[i] = EEPROM.read(ADDR_SN0 + i);
+  }
+}
+
+// Escribir el bloque (solo los bytes modificados) y confirmar
+// El CRC se calcula con el lock tomado, junto con la copia que cubre
+static void storeConfigBlock() {
+  lockStorage();
+  configBlock.magic = CONFIG_BLOCK_MAGIC;
+  configBlock.version = CONFIG_BLOCK_VERSION;
+  configBlock.length = sizeof(ConfigBlock);
+  configBlock.crc = configBlockCrc(&configBlock);
+  
+  const uint8_t* bytes = (const uint8_t*)&configBlock;
+  for (size_t i = 0; i < sizeof(ConfigBlock); i++) {
+    storageWriteLocked(ADDR_CONFIG_BLOCK + i, bytes[i]);
+  }
+  unlockStorage();
+  
+  configVersion++;
+  storageAutoCommit();
+}
+
+// Cargar el bloque de la EEPROM con una sola copia y validarlo
+static void loadConfigBlock() {
+  configBlockLoaded = true;
+  EEPROM.get(ADDR_CONFIG_BLOCK, configBlock);
+  
+  if (configBlock.magic != CONFIG_BLOCK_MAGIC) {
+    // Nunca se grabó un bloque: migrar desde el esquema heredado
+    logDebug("Migrando configuración al bloque versionado");
+    migrateLegacyConfig(&configBlock);
+    storeConfigBlock();
+    return;
+  }
+  
+  if (configBlock.length > sizeof(ConfigBlock) ||
+      configBlock.crc != configBlockCrc(&configBlock)) {
+    // Bloque a medio grabar o dañado: no usar sus valores
+    logError("Bloque de configuración corrupto, usando valores predeterminados");
+    setConfigBlockDefaults(&configBlock);
+    storeConfigBlock();
+    return;
+  }
+  
+  // Versiones anteriores del bloque se migran aquí campo por campo
+  // (por ahora solo existe la versión 1)
+  if (configBlock.version != CONFIG_BLOCK_VERSION) {
+    logError("Versión de bloque de configuración desconocida, usando valores predeterminados");
+    setConfigBlockDefaults(&configBlock);
+    storeConfigBlock();
+  }
+}
+
+static void ensureConfigBlock() {
+  if (!configBlockLoaded) loadConfigBlock();
+}
+
+// Leer configuración de la EEPROM
+void readConfigFromEEPROM() {
+  ensureConfigBlock();
+  
+  config.deviceId = configBlock.deviceId;
+  sprintf(config.deviceIdStr, "%02X", config.deviceId);
+  
+  strcpy(config.nombre_empresa, configBlock.nombre_empresa);
+  
+  config.modo_tcpip485 = configBlock.modo_tcpip485;
+  config.modo_work = configBlock.modo_work;
+  config.modo_display = configBlock.modo_display;
+  config.modo_QR_8_12 = configBlock.modo_QR_8_12;
+  config.modo_clock = configBlock.modo_clock;
+  config.modo_sens_altura = configBlock.modo_sens_altura;
+  
+  // Deducir si es puerta de entrada
+  config.esPuertaEntrada = (config.modo_work != 4);
+}
+
+// Restablecer configuración a valores predeterminados
+void resetConfigToDefaults() {
+  ensureConfigBlock();
+  setConfigBlockDefaults(&configBlock);
+  storeConfigBlock();
+  
+  readConfigFromEEPROM();
+}
+
+// Funciones específicas
+uint8_t loadRelayTimer(int relayNum) {
+  if (relayNum < 1 || relayNum > 5) return 5; // Valor predeterminado
+  
+  ensureConfigBlock();
+  return configBlock.relayTime[relayNum - 1];
+}
+
+uint8_t loadDeviceId() {
+  ensureConfigBlock();
+  return configBlock.deviceId;
+}
+
+void saveDeviceId(uint8_t id) {
+  ensureConfigBlock();
+  configBlock.deviceId = id;
+  storeConfigBlock();
+}
+
+void loadCompanyName(char* name, size_t maxLen) {
+  ensureConfigBlock();
+  safeStrCopy(name, configBlock.nombre_empresa, maxLen);
+}
+
+void saveCompanyName(const char* name) {
+  ensureConfigBlock();
+  memset(configBlock.nombre_empresa, 0, sizeof(configBlock.nombre_empresa));
+  safeStrCopy(configBlock.nombre_empresa, name, sizeof(configBlock.nombre_empresa));
+  storeConfigBlock();
+}
+
+void saveTcpIpMode(uint8_t mode) {
+  ensureConfigBlock();
+  configBlock.modo_tcpip485 = mode;
+  storeConfigBlock();
+}
+
+void saveWorkMode(uint8_t mode) {
+  ensureConfigBlock();
+  configBlock.modo_work = mode;
+  storeConfigBlock();
+}
+
+void saveDisplayMode(uint8_t mode) {
+  ensureConfigBlock();
+  configBlock.modo_display = mode;
+  storeConfigBlock();
+}
+
+void saveQRMode(uint8_t mode) {
+  ensureConfigBlock();
+  configBlock.modo_QR_8_12 = mode;
+  storeConfigBlock();
+}
+
+void saveClockMode(uint8_t mode) {
+  ensureConfigBlock();
+  configBlock.modo_clock = mode;
+  storeConfigBlock();
+}
+
+void saveSensorMode(uint8_t mode) {
+  ensureConfigBlock();
+  configBlock.modo_sens_altura = mode;
+  storeConfigBlock();
+}
+
+// Cargar modos desde el bloque de configuración
+uint8_t loadTcpIpMode() {
+  ensureConfigBlock();
+  return configBlock.modo_tcpip485;
+}
+
+uint8_t loadWorkMode() {
+  ensureConfigBlock();
+  return configBlock.modo_work;
+}
+
+uint8_t loadDisplayMode() {
+  ensureConfigBlock();
+  return configBlock.modo_display;
+}
+
+uint8_t loadQRMode() {
+  ensureConfigBlock();
+  return configBlock.modo_QR_8_12;
+}
+
+uint8_t loadClockMode() {
+  ensureConfigBlock();
+  return configBlock.modo_clock;
+}
+
+uint8_t loadSensorMode() {
+  ensureConfigBlock();
+  return configBlock.modo_sens_altura;
+}
+
+void saveRelayTimer(int relayNum, uint8_t time) {
+  if (relayNum < 1 || relayNum > 5) return; // Validación
+  
+  ensureConfigBlock();
+  configBlock.relayTime[relayNum - 1] = time;
+  storeConfigBlock();
+}
+
+// Tiempos de los detectores de masa metálica
+// Índices: 0 = presencia DDMM1, 1 = ausencia DDMM1, 2 = presencia DDMM2, 3 = ausencia DDMM2
+void saveDDMMTime(int index, uint8_t time) {
+  if (index < 0 || index > 3) return; // Validación
+  
+  ensureConfigBlock();
+  configBlock.ddmmTime[index] = time;
+  storeConfigBlock();
+}
+
+uint8_t loadDDMMTime(int index) {
+  if (index < 0 || index > 3) return 0; // Validación
+  
+  ensureConfigBlock();
+  return configBlock.ddmmTime[index];
+}
+
+void saveSerialNumber(int index, uint8_t value) {
+  if (index < 0 || index > 4) return; // Validación
+  
+  ensureConfigBlock();
+  configBlock.serialNumber[index] = value;
+  storeConfigBlock();
+}
+
+uint8_t loadSerialNumber(int index) {
+  if (index < 0 || index > 4) return 0; // Validación
+  
+  ensureConfigBlock();
+  return configBlock.serialNumber[index];
+}
+
+// Funciones para tickets
+void saveTicketLine(int lineNum, const char* text) {
+  if (lineNum < 1 || lineNum > 4) return; // Validación
+  
+  ensureConfigBlock();
+  char* line = configBlock.ticketLine[lineNum - 1];
+  memset(line, 0, sizeof(configBlock.ticketLine[0]));
+  safeStrCopy(line, text, sizeof(configBlock.ticketLine[0]));
+  storeConfigBlock();
+}
+
+void loadTicketLine(int lineNum, char* text, size_t maxLen) {
+  if (lineNum < 1 || lineNum > 4) {
+    text[0] = 0;
+    return;
+  }
+  
+  ensureConfigBlock();
+  safeStrCopy(text, configBlock.ticketLine[lineNum - 1], maxLen);
+}
+
+// Contador de tickets en formato heredado (ASCII en la EEPROM emulada)
+// Solo se usa si no hay región de flash para el log o para migrar
+static bool saveLegacyTicketCounter(uint32_t counter) {
+  // La unidad de mil ocupa un byte: más allá no se puede guardar
+  if (counter > LEGACY_TICKET_MAX) {
+    logError("Contador de tickets fuera del formato heredado");
+    return false;
+  }
+  
+  uint8_t unidadMil = counter / 1000;
+  uint16_t resto = counter % 1000;
+  
+  storageWrite(ADDR_UNIDAD_MILES, unidadMil);
+  
+  char buffer[4];
+  sprintf(buffer, "%03d", resto);
+  
+  for (int i = 0; i < 3; i++) {
+    storageWrite(ADDR_TICKET_NUMBER + i, buffer[i]);
+  }
+  
+  // Una reserva tiene que estar en flash antes de emitir su primer número:
+  // con el commit diferido, un corte en esa ventana repetiría la numeración
+  return syncStorage();
+}
+
+static bool loadLegacyTicketCounter(uint32_t* counter) {
+  uint8_t unidadMil = EEPROM.read(ADDR_UNIDAD_MILES);
+  if (unidadMil == 0xFF) return false; // EEPROM sin grabar
+  
+  char buffer[4];
+  for (int i = 0; i < 3; i++) {
+    buffer[i] = EEPROM.read(ADDR_TICKET_NUMBER + i);
+    if (buffer[i] < '0' || buffer[i] > '9') return false;
+  }
+  buffer[3] = 0;
+  
+  uint16_t resto = atoi(buffer);
+  
+  *counter = unidadMil * 1000 + resto;
+  return true;
+}
+
+bool saveTicketCounter(uint32_t counter) {
+  if (!ticketLog.available) return saveLegacyTicketCounter(counter);
+  
+  if (ticketLog.valid && counter == ticketLog.counter) return true; // Sin cambios
+  
+  return appendTicketLog(counter);
+}
+
+uint32_t loadTicketCounter() {
+  if (ticketLog.available) {
+    return ticketLog.valid ? ticketLog.counter : 0;
+  }
+  
+  uint32_t counter = 0;
+  loadLegacyTicketCounter(&counter);
+  return counter;
+}
+
+// Numeración de tickets
+// El contador vive en RAM y se reservan bloques de TICKET_RESERVE_BLOCK números:
+// solo se escribe en flash al agotar la reserva. Lo persistido es siempre el
+// próximo número que se puede emitir, así que tras un reinicio inesperado se
+// salta el resto de la reserva y ningún número se repite. Si la reserva no se
+// pudo grabar no se emite ningún número.
+static uint32_t nextTicket = 0;        // Próximo número a emitir
+static uint32_t reservedTicket = 0;    // Primer número fuera de la reserva
+static bool ticketCounterReady = false;
+
+static void ensureTicketCounter() {
+  if (ticketCounterReady) return;
+  
+  nextTicket = loadTicketCounter();
+  if (nextTicket == 0) nextTicket = 1; // Los tickets empiezan en 1
+  reservedTicket = nextTicket;         // Obliga a reservar antes de emitir
+  ticketCounterReady = true;
+}
+
+uint32_t issueTicketNumber() {
+  ensureTicketCounter();
+  
+  if (nextTicket >= reservedTicket) {
+    uint32_t reserve = nextTicket + TICKET_RESERVE_BLOCK;
+    
+    // Sin log en flash el formato heredado pone un tope: reservar hasta ahí
+    if (!ticketLog.available && reserve > LEGACY_TICKET_MAX) reserve = LEGACY_TICKET_MAX;
+    if (reserve <= nextTicket || !saveTicketCounter(reserve)) return 0;
+    
+    reservedTicket = reserve;
+  }
+  
+  return nextTicket++;
+}
+
+// Guardar el valor exacto (apagado ordenado) para no saltar números al reiniciar
+void flushTicketCounter() {
+  if (!ticketCounterReady) return;
+  
+  // Si falla, sigue valiendo la reserva ya grabada (mayor)
+  if (saveTicketCounter(nextTicket)) reservedTicket = nextTicket;
+}
+
+// Funciones EEPROM básicas
+uint8_t readEEPROM(int address) {
+  return EEPROM.read(address);
+}
+
+void writeEEPROM(int address, uint8_t value) {
+  storageWrite(address, value);
+  storageAutoCommit();
+}
+
+void writeEEPROMBlock(int address, const uint8_t* data, size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    storageWrite(address + i, data[i]);
+  }
+  
+  storageAutoCommit();
+}
+
+void readEEPROMBlock(int address, uint8_t* data, size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    data[i] = EEPROM.read(address + i);
+  }
+}
+
+// Escritura de configuración completa
+void writeConfigToEEPROM() {
+  ensureConfigBlock();
+  configBlock.deviceId = config.deviceId;
+  memset(configBlock.nombre_empresa, 0, sizeof(configBlock.nombre_empresa));
+  safeStrCopy(configBlock.nombre_empresa, config.nombre_empresa, sizeof(configBlock.nombre_empresa));
+  configBlock.modo_tcpip485 = config.modo_tcpip485;
+  configBlock.modo_work = config.modo_work;
+  configBlock.modo_display = config.modo_display;
+  configBlock.modo_QR_8_12 = config.modo_QR_8_12;
+  configBlock.modo_clock = config.modo_clock;
+  configBlock.modo_sens_altura = config.modo_sens_altura;
+  storeConfigBlock();
+}
+
+size_t getStorageRam() {
+  return sizeof(configBlock);
+}
@@ -1,325 +1,581 @@
-#include "apis.h"
-#include "protocolo.h"
-#include "utilidades.h"
-#include "estructuras.h"
-#include <ArduinoJson.h>
-
-#ifdef ESP8266
-  #include <ESP8266WebServer.h>
-  extern ESP8266WebServer server;
-#elif defined(ESP32)
-  #include <WebServer.h>
-  extern WebServer server;
-#endif
-
-// Inicialización de la API
-void setupApi() {
-  // Configurar rutas para la API REST
-  server.on("/api/status", HTTP_GET, handleApiStatus);
-  server.on("/api/relay", HTTP_POST, handleApiRelay);
-  server.on("/api/command", HTTP_POST, handleApiCommand);
-  server.on("/api/config", HTTP_GET, handleApiGetConfig);
-  server.on("/api/config", HTTP_POST, handleApiSetConfig);
-  server.on("/api/reset", HTTP_POST, handleApiReset);
-}
-
-// Implementación de endpoints de la API
-
-// GET /api/status - Obtener el estado actual
-bool apiGetStatus(String& response) {
-  // Crear objeto JSON para la respuesta
-  StaticJsonDocument<256> doc;
-  
-  // Añadir información de status
-  doc["success"] = true;
-  doc["deviceId"] = config.deviceId;
-  doc["status"] = statusInfo.status;
-  doc["statusHex"] = statusInfo.statusHex;
-  
-  // Agregar estado de bits individuales para facilitar uso
-  JsonObject bits = doc.createNestedObject("bits");
-  bits["ddmm1"] = isStatusBitSet(STATUS_DDMM1);
-  bits["ddmm2"] = isStatusBitSet(STATUS_DDMM2);
-  bits["relay1"] = isStatusBitSet(STATUS_RELAY1);
-  bits["relay2"] = isStatusBitSet(STATUS_RELAY2);
-  bits["tarjeta"] = isStatusBitSet(STATUS_TARJ);
-  bits["fraude"] = isStatusBitSet(STATUS_FRAUDE);
-  bits["pulso"] = isStatusBitSet(STATUS_PULS);
-  bits["scanner"] = isStatusBitSet(STATUS_SCANNER);
-  bits["salida"] = isStatusBitSet(STATUS_SALIDA);
-  
-  // Añadir datos RFID si hay
-  if (strlen(statusInfo.rfidData) > 0) {
-    doc["rfidData"] = statusInfo.rfidData;
-  }
-  
-  // Serializar a JSON
-  serializeJson(doc, response);
-  
-  return true;
-}
-
-// POST /api/relay - Activar/Desactivar un relé
-bool apiActivateRelay(int relayNum, bool activate, String& response) {
-  StaticJsonDocument<128> doc;
-  bool success = false;
-  
-  if (relayNum >= 1 && relayNum <= 5) {
-    if (activate) {
-      success = activateRelay(relayNum);
-    } else {
-      success = deactivateRelay(relayNum);
-    }
-    
-    doc["success"] = success;
-    doc["relay"] = relayNum;
-    doc["state"] = activate ? "activated" : "deactivated";
-    doc["message"] = success ? 
-                     (activate ? "Relé activado correctamente" : "Relé desactivado correctamente") : 
-                     "Error al cambiar estado del relé";
-  } else {
-    doc["success"] = false;
-    doc["message"] = "Número de relé inválido. Debe estar entre 1 y 5.";
-  }
-  
-  serializeJson(doc, response);
-  return success;
-}
-
-// POST /api/command - Enviar un comando al dispositivo OemAccess
-bool apiSendCommand(const String& commandStr, String& response) {
-  StaticJsonDocument<256> doc;
-  
-  // Procesar el comando
-  const char* command = commandStr.c_str();
-  CommandResponse cmdResponse = processCommand(command);
-  
-  // Preparar respuesta JSON
-  doc["success"] = cmdResponse.success;
-  doc["command"] = commandStr;
-  doc["message"] = cmdResponse.message;
-  
-  if (strlen(cmdResponse.data) > 0) {
-    doc["data"] = cmdResponse.data;
-  }
-  
-  serializeJson(doc, response);
-  return cmdResponse.success;
-}
-
-// GET /api/config - Obtener configuración actual
-bool apiGetConfig(String& response) {
-  StaticJsonDocument<384> doc;
-  
-  doc["deviceId"] = config.deviceId;
-  doc["deviceIdStr"] = config.deviceIdStr;
-  doc["companyName"] = config.nombre_empresa;
-  doc["tcpipMode"] = config.modo_tcpip485;
-  doc["workMode"] = config.modo_work;
-  doc["displayMode"] = config.modo_display;
-  doc["qrMode"] = config.modo_QR_8_12;
-  doc["clockMode"] = config.modo_clock;
-  doc["sensorMode"] = config.modo_sens_altura;
-  doc["isEntrance"] = config.esPuertaEntrada;
-  
-  // Añadir información de relés
-  JsonArray relaysArray = doc.createNestedArray("relays");
-  for (int i = 0; i < 5; i++) {
-    JsonObject relay = relaysArray.createNestedObject();
-    relay["number"] = i + 1;
-    relay["pin"] = relays[i].pin;
-    relay["state"] = relays[i].state;
-    relay["time"] = relays[i].time;
-  }
-  
-  serializeJson(doc, response);
-  return true;
-}
-
-// POST /api/config - Actualizar configuración
-bool apiSetConfig(const String& configJson, String& response) {
-  StaticJsonDocument<384> doc;
-  DeserializationError error = deserializeJson(doc, configJson);
-  
-  if (error) {
-    String errMsg = "Error al procesar JSON: ";
-    errMsg += error.c_str();
-    
-    StaticJsonDocument<128> errorDoc;
-    errorDoc["success"] = false;
-    errorDoc["message"] = errMsg;
-    serializeJson(errorDoc, response);
-    return false;
-  }
-  
-  bool needsRestart = false;
-  
-  // Actualizar configuración
-  if (doc.containsKey("deviceId")) {
-    uint8_t newId = doc["deviceId"];
-    if (newId != config.deviceId) {
-      saveDeviceId(newId);
-      needsRestart = true;
-    }
-  }
-  
-  if (doc.containsKey("companyName")) {
-    const char* name = doc["companyName"];
-    saveCompanyName(name);
-    strcpy(config.nombre_empresa, name);
-  }
-  
-  if (doc.containsKey("tcpipMode")) {
-    uint8_t mode = doc["tcpipMode"];
-    if (mode != config.modo_tcpip485) {
-      saveTcpIpMode(mode);
-      needsRestart = true;
-    }
-  }
-  
-  if (doc.containsKey("workMode")) {
-    uint8_t mode = doc["workMode"];
-    if (mode != config.modo_work) {
-      saveWorkMode(mode);
-      needsRestart = true;
-    }
-  }
-  
-  if (doc.containsKey("displayMode")) {
-    uint8_t mode = doc["displayMode"];
-    if (mode != config.modo_display) {
-      saveDisplayMode(mode);
-      needsRestart = true;
-    }
-  }
-  
-  if (doc.containsKey("qrMode")) {
-    uint8_t mode = doc["qrMode"];
-    if (mode != config.modo_QR_8_12) {
-      saveQRMode(mode);
-      needsRestart = true;
-    }
-  }
-  
-  if (doc.containsKey("clockMode")) {
-    uint8_t mode = doc["clockMode"];
-    if (mode != config.modo_clock) {
-      saveClockMode(mode);
-      needsRestart = true;
-    }
-  }
-  
-  if (doc.containsKey("sensorMode")) {
-    uint8_t mode = doc["sensorMode"];
-    if (mode != config.modo_sens_altura) {
-      saveSensorMode(mode);
-      needsRestart = true;
-    }
-  }
-  
-  if (doc.containsKey("isEntrance")) {
-    bool isEntrance = doc["isEntrance"];
-    config.esPuertaEntrada = isEntrance;
-    // No es necesario guardar, ya que se deduce del modo de trabajo
-  }
-  
-  // Relés
-  if (doc.containsKey("relays")) {
-    JsonArray relaysArray = doc["relays"];
-    for (JsonObject relay : relaysArray) {
-      if (relay.containsKey("number") && relay.containsKey("time")) {
-        int number = relay["number"];
-        uint8_t time = relay["time"];
-        if (number >= 1 && number <= 5) {
-          setRelayTimer(number, time);
-        }
-      }
-    }
-  }
-  
-  // Preparar respuesta
-  StaticJsonDocument<128> respDoc;
-  respDoc["success"] = true;
-  respDoc["message"] = "Configuración actualizada correctamente";
-  respDoc["needsRestart"] = needsRestart;
-  
-  serializeJson(respDoc, response);
-  return true;
-}
-
-// POST /api/reset - Reiniciar el dispositivo
-bool apiReset(String& response) {
-  StaticJsonDocument<128> doc;
-  doc["success"] = true;
-  doc["message"] = "Reiniciando dispositivo...";
-  
-  serializeJson(doc, response);
-  
-  // Programar reinicio en 1 segundo para permitir enviar la respuesta
-  #ifdef ESP8266
-    ESP.wdtDisable();
-    ESP.restart();
-  #elif defined(ESP32)
-    ESP.restart();
-  #endif
-  
-  return true;
-}
-
-// Manejadores para endpoints HTTP
-void handleApiStatus() {
-  String response;
-  apiGetStatus(response);
-  server.send(200, "application/json", response);
-}
-
-void handleApiRelay() {
-  if (!server.hasArg("relay") || !server.hasArg("action")) {
-    server.send(400, "application/json", "{\"success\":false,\"message\":\"Parámetros faltantes\"}");
-    return;
-  }
-  
-  int relayNum = server.arg("relay").toInt();
-  String action = server.arg("action");
-  bool activate = (action == "activate");
-  
-  String response;
-  apiActivateRelay(relayNum, activate, response);
-  server.send(200, "application/json", response);
-}
-
-void handleApiCommand() {
-  if (!server.hasArg("command")) {
-    server.send(400, "application/json", "{\"success\":false,\"message\":\"Parámetro 'command' requerido\"}");
-    return;
-  }
-  
-  String command = server.arg("command");
-  String response;
-  apiSendCommand(command, response);
-  server.send(200, "application/json", response);
-}
-
-void handleApiGetConfig() {
-  String response;
-  apiGetConfig(response);
-  server.send(200, "application/json", response);
-}
-
-void handleApiSetConfig() {
-  if (!server.hasArg("plain")) {
-    server.send(400, "application/json", "{\"success\":false,\"message\":\"Configuración JSON requerida\"}");
-    return;
-  }
-  
-  String configJson = server.arg("plain");
-  String response;
-  apiSetConfig(configJson, response);
-  server.send(200, "application/json", response);
-}
-
-void handleApiReset() {
-  String response;
-  apiReset(response);
-  server.send(200, "application/json", response);
-}
\ No newline at end of file
+#include "apis.h"
+#include "perfil.h"
+#include "protocolo.h"
+#include "utilidades.h"
+#include "estructuras.h"
+#include "almacenamiento.h"
+#include "web.h"
+#include "servidor.h"
+#include "metricas.h"
+#include "tareas.h"
+#include "arena.h"
+#include "memoria.h"
+#include "mensajes.h"
+#include <ArduinoJson.h>
+
+// Solo en perfiles con API REST (perfil.h)
+#if PROFILE_REST_API
+
+// Caché de respuestas JSON
+// El cuerpo serializado se guarda junto con la versión de los datos de origen
+// y solo se regenera cuando esa versión cambia
+struct ResponseCache {
+  bool valid;
+  uint32_t version;            // statusVersion o configVersion al serializar
+  uint32_t variant;            // Datos volátiles que no incrementan la versión
+  size_t length;
+  char etag[32];
+  char* body;
+  size_t size;
+};
+
+static char statusBody[API_STATUS_CACHE_SIZE];
+static char configBody[API_CONFIG_CACHE_SIZE];
+static ResponseCache statusCache = {false, 0, 0, 0, "", statusBody, sizeof(statusBody)};
+static ResponseCache configCache = {false, 0, 0, 0, "", configBody, sizeof(configBody)};
+
+// Identificador de arranque: evita que un ETag de antes de un reinicio
+// coincida con las versiones, que vuelven a empezar desde cero
+static uint32_t bootId = 0;
+
+// Agregar la respuesta del protocolo capturada: la trama completa y su
+// contenido sin STX/ID ni terminador (ACK y NAK se informan por nombre)
+static void addProtocolReply(JsonDocument& doc, const char* reply) {
+  if (reply[0] == '\0') return;
+  doc["reply"] = reply;
+  
+  if (reply[0] != STX || strlen(reply) < 4) return;
+  
+  if (reply[3] == ACK) {
+    doc["payload"] = "ACK";
+  } else if (reply[3] == NAK) {
+    doc["payload"] = "NAK";
+  } else {
+    char payload[64];
+    size_t len = 0;
+    for (const char* p = reply + 3; *p != '\0' && *p != ETX && *p != SIB && len < sizeof(payload) - 1; p++) {
+      payload[len++] = *p;
+    }
+    payload[len] = '\0';
+    doc["payload"] = payload;
+  }
+}
+
+// Estado de los relés empaquetado (3 bits por relé) para la clave de /api/config
+static uint32_t relayStateSignature(const StatusSnapshot& snapshot) {
+  uint32_t signature = 0;
+  for (int i = 0; i < RELAY_COUNT; i++) {
+    signature |= (uint32_t)(snapshot.relayState[i] & 0x07) << (i * 3);
+  }
+  return signature;
+}
+
+// Enviar una respuesta JSON desde la caché, regenerándola si cambió la versión
+// Si el cliente envía el ETag vigente en If-None-Match se responde 304 sin cuerpo
+static void sendCachedJson(ResponseCache& cache, uint32_t version, uint32_t variant, bool (*build)(Print&)) {
+  if (!cache.valid || cache.version != version || cache.variant != variant) {
+    BufferPrint out(cache.body, cache.size);
+    build(out);
+    
+    cache.valid = !out.overflowed();
+    cache.version = version;
+    cache.variant = variant;
+    cache.length = out.written();
+    snprintf(cache.etag, sizeof(cache.etag), "\"%08lx-%lx-%lx\"",
+             (unsigned long)bootId, (unsigned long)version, (unsigned long)variant);
+    
+    if (!cache.valid) {
+      // No entra en el buffer: enviar sin caché
+      ChunkedResponse response;
+      response.begin(200, "application/json");
+      build(response);
+      response.end();
+      return;
+    }
+  }
+  
+  server.sendHeader("ETag", cache.etag);
+  server.sendHeader("Cache-Control", "no-cache");
+  
+  if (strcmp(server.header("If-None-Match"), cache.etag) == 0) {
+    server.send(304);
+    return;
+  }
+  
+  server.setContentLength(cache.length);
+  server.send(200, "application/json", "");
+  server.sendContent(cache.body, cache.length);
+}
+
+// Enviar el JSON armado en la arena; si no entró, un error en lugar de un JSON cortado
+static void sendArenaJson(int code, ArenaPrint& body) {
+  if (body.overflowed()) {
+    server.send(500, "application/json", "{\"success\":false,\"message\":\"Respuesta demasiado grande\"}");
+    return;
+  }
+  
+  server.send(code, "application/json", body.c_str());
+}
+
+// Inicialización de la API
+void setupApi() {
+  #ifdef ESP8266
+    bootId = RANDOM_REG32;
+  #elif defined(ESP32)
+    bootId = esp_random();
+  #endif
+  
+  // Configurar rutas para la API REST
+  // Las que actúan sobre relés o flash llevan límite (pedidos por minuto, ráfaga)
+  server.on("/api/status", HTTP_GET, handleApiStatus);
+  server.on("/api/relay", HTTP_POST, handleApiRelay, 120, 10);
+  server.on("/api/command", HTTP_POST, handleApiCommand, 120, 10);
+  server.on("/api/commands", HTTP_POST, handleApiCommands, 30, 3);
+  server.on("/api/config", HTTP_GET, handleApiGetConfig);
+  server.on("/api/config", HTTP_POST, handleApiSetConfig, 10, 3);
+  server.on("/api/reset", HTTP_POST, handleApiReset, 2, 1);
+  server.on("/api/sync", HTTP_POST, handleApiSync, 6, 2);
+  server.on("/api/tasks", HTTP_GET, handleApiTasks);
+  server.on("/api/memory", HTTP_GET, handleApiMemory);
+  server.on("/metrics", HTTP_GET, handleMetrics);
+}
+
+// Implementación de endpoints de la API
+
+// GET /api/status - Obtener el estado actual
+// Se arma con la copia publicada por la tarea de protocolo, no con los globales
+bool apiGetStatus(Print& response) {
+  StatusSnapshot snapshot;
+  readStatusSnapshot(snapshot);
+  
+  // Crear objeto JSON para la respuesta
+  StaticJsonDocument<256> doc;
+  
+  // Añadir información de status
+  doc["success"] = true;
+  doc["deviceId"] = snapshot.config.deviceId;
+  doc["status"] = snapshot.status;
+  doc["statusHex"] = snapshot.statusHex;
+  
+  // Agregar estado de bits individuales para facilitar uso
+  JsonObject bits = doc.createNestedObject("bits");
+  bits["ddmm1"] = (snapshot.status & STATUS_DDMM1) != 0;
+  bits["ddmm2"] = (snapshot.status & STATUS_DDMM2) != 0;
+  bits["relay1"] = (snapshot.status & STATUS_RELAY1) != 0;
+  bits["relay2"] = (snapshot.status & STATUS_RELAY2) != 0;
+  bits["tarjeta"] = (snapshot.status & STATUS_TARJ) != 0;
+  bits["fraude"] = (snapshot.status & STATUS_FRAUDE) != 0;
+  bits["pulso"] = (snapshot.status & STATUS_PULS) != 0;
+  bits["scanner"] = (snapshot.status & STATUS_SCANNER) != 0;
+  bits["salida"] = (snapshot.status & STATUS_SALIDA) != 0;
+  
+  // Añadir datos RFID si hay
+  if (strlen(snapshot.rfidData) > 0) {
+    doc["rfidData"] = snapshot.rfidData;
+  }
+  
+  // Serializar a JSON directamente a la salida
+  serializeJson(doc, response);
+  
+  return true;
+}
+
+// POST /api/relay - Activar/Desactivar un relé
+// Se ejecuta como S1-S5 / R1-R5 en la tarea de protocolo, dueña de los relés
+bool apiActivateRelay(int relayNum, bool activate, Print& response) {
+  StaticJsonDocument<128> doc;
+  bool success = false;
+  
+  if (relayNum >= 1 && relayNum <= RELAY_COUNT) {
+    char command[3] = {activate ? 'S' : 'R', (char)('0' + relayNum), '\0'};
+    char reply[API_REPLY_SIZE];
+    CommandResponse cmdResponse = runCommand(command, reply, sizeof(reply));
+    success = cmdResponse.success;
+    
+    doc["success"] = success;
+    doc["relay"] = relayNum;
+    doc["state"] = activate ? "activated" : "deactivated";
+    if (commandPending(cmdResponse)) {
+      doc["pending"] = true;
+      doc["message"] = "Cambio de relé en curso, sin confirmar";
+    } else {
+      doc["message"] = success ? 
+                       (activate ? "Relé activado correctamente" : "Relé desactivado correctamente") : 
+                       "Error al cambiar estado del relé";
+    }
+  } else {
+    char message[64];
+    snprintf(message, sizeof(message), "Número de relé inválido. Debe estar entre 1 y %d.", RELAY_COUNT);
+    doc["success"] = false;
+    doc["message"] = message;
+  }
+  
+  serializeJson(doc, response);
+  return success;
+}
+
+// POST /api/command - Enviar un comando al dispositivo OemAccess
+// La respuesta del protocolo vuelve en el JSON; no se transmite nada por RS485
+bool apiSendCommand(const char* commandStr, Print& response) {
+  StaticJsonDocument<512> doc;
+  
+  // Procesar el comando capturando su respuesta
+  char reply[API_REPLY_SIZE];
+  CommandResponse cmdResponse = runCommand(commandStr, reply, sizeof(reply));
+  
+  // Preparar respuesta JSON (el texto del mensaje se arma recién aquí)
+  char message[MESSAGE_TEXT_SIZE];
+  formatMessage(cmdResponse, message, sizeof(message));
+  doc["success"] = cmdResponse.success;
+  doc["command"] = commandStr;
+  doc["message"] = message;
+  if (commandPending(cmdResponse)) doc["pending"] = true;
+  
+  if (strlen(cmdResponse.data) > 0) {
+    doc["data"] = cmdResponse.data;
+  }
+  addProtocolReply(doc, reply);
+  
+  serializeJson(doc, response);
+  return cmdResponse.success;
+}
+
+// POST /api/commands - Ejecutar una lista de comandos en orden
+// Las escrituras de todos los comandos se confirman en un único commit a flash.
+// Si un comando no termina a tiempo el lote se corta ahí: los siguientes no se
+// ejecutan ("executed" cuenta solo los intentados)
+bool apiSendCommands(const char* commandsJson, Print& response) {
+  StaticJsonDocument<1024> doc;
+  DeserializationError error = deserializeJson(doc, commandsJson);
+  
+  if (error || !doc.is<JsonArray>()) {
+    StaticJsonDocument<128> errorDoc;
+    errorDoc["success"] = false;
+    errorDoc["message"] = "Se esperaba un arreglo JSON de comandos";
+    serializeJson(errorDoc, response);
+    return false;
+  }
+  
+  JsonArray commands = doc.as<JsonArray>();
+  if (commands.size() > API_MAX_BATCH_COMMANDS) {
+    StaticJsonDocument<128> errorDoc;
+    errorDoc["success"] = false;
+    errorDoc["message"] = "Demasiados comandos en el lote";
+    serializeJson(errorDoc, response);
+    return false;
+  }
+  
+  bool allSuccess = true;
+  int executed = 0;
+  
+  // Los resultados se escriben uno por uno para no retener todo el lote en RAM
+  response.print("{\"results\":[");
+  
+  beginCommandBatch();
+  
+  for (JsonVariant item : commands) {
+    const char* command = item.as<const char*>();
+    CommandResponse cmdResponse = {false, MSG_INVALID_COMMAND, 0, ""};
+    char reply[API_REPLY_SIZE] = "";
+    
+    if (command != NULL) {
+      cmdResponse = runCommand(command, reply, sizeof(reply));
+    }
+    
+    char message[MESSAGE_TEXT_SIZE];
+    formatMessage(cmdResponse, message, sizeof(message));
+    
+    StaticJsonDocument<512> result;
+    result["command"] = command;
+    result["success"] = cmdResponse.success;
+    result["message"] = message;
+    if (commandPending(cmdResponse)) result["pending"] = true;
+    if (strlen(cmdResponse.data) > 0) {
+      result["data"] = cmdResponse.data;
+    }
+    addProtocolReply(result, reply);
+    
+    if (executed > 0) response.print(",");
+    serializeJson(result, response);
+    
+    allSuccess = allSuccess && cmdResponse.success;
+    executed++;
+    
+    // La tarea de protocolo está ocupada: no encolar más detrás
+    if (commandPending(cmdResponse) || cmdResponse.message == MSG_TASK_TIMEOUT) break;
+  }
+  
+  // El commit queda para cuando termine el último comando, aunque esté pendiente
+  endCommandBatch();
+  
+  response.print("],\"executed\":");
+  response.print(executed);
+  response.print(",\"success\":");
+  response.print(allSuccess ? "true" : "false");
+  response.print("}");
+  
+  return allSuccess;
+}
+
+// GET /api/config - Obtener configuración actual
+// Como /api/status, sale de la copia publicada por la tarea de protocolo
+bool apiGetConfig(Print& response) {
+  StaticJsonDocument<384> doc;
+  StatusSnapshot snapshot;
+  readStatusSnapshot(snapshot);
+  const DeviceConfig& current = snapshot.config;
+  
+  doc["deviceId"] = current.deviceId;
+  doc["deviceIdStr"] = current.deviceIdStr;
+  doc["companyName"] = current.nombre_empresa;
+  doc["tcpipMode"] = current.modo_tcpip485;
+  doc["workMode"] = current.modo_work;
+  doc["displayMode"] = current.modo_display;
+  doc["qrMode"] = current.modo_QR_8_12;
+  doc["clockMode"] = current.modo_clock;
+  doc["sensorMode"] = current.modo_sens_altura;
+  doc["isEntrance"] = current.esPuertaEntrada;
+  
+  // Añadir información de relés (el pin no cambia después de setup())
+  JsonArray relaysArray = doc.createNestedArray("relays");
+  for (int i = 0; i < RELAY_COUNT; i++) {
+    JsonObject relay = relaysArray.createNestedObject();
+    relay["number"] = i + 1;
+    relay["pin"] = relays[i].pin;
+    relay["state"] = snapshot.relayState[i];
+    relay["time"] = snapshot.relayTime[i];
+  }
+  
+  serializeJson(doc, response);
+  return true;
+}
+
+// POST /api/config - Actualizar configuración
+// Aquí solo se arma el pedido: lo aplica la tarea de protocolo (applyConfigUpdate)
+bool apiSetConfig(const char* configJson, Print& response) {
+  StaticJsonDocument<384> doc;
+  DeserializationError error = deserializeJson(doc, configJson);
+  
+  if (error) {
+    char message[64];
+    snprintf(message, sizeof(message), "Error al procesar JSON: %s", error.c_str());
+    
+    StaticJsonDocument<128> errorDoc;
+    errorDoc["success"] = false;
+    errorDoc["message"] = message;
+    serializeJson(errorDoc, response);
+    return false;
+  }
+  
+  ConfigUpdate update;
+  memset(&update, 0, sizeof(update));
+  DeviceConfig& next = update.config;
+  
+  if (doc.containsKey("deviceId")) {
+    update.fields |= CONFIG_UPDATE_DEVICE_ID;
+    next.deviceId = doc["deviceId"];
+  }
+  
+  if (doc.containsKey("companyName")) {
+    update.fields |= CONFIG_UPDATE_COMPANY;
+    const char* name = doc["companyName"];
+    safeStrCopy(next.nombre_empresa, name != NULL ? name : "", sizeof(next.nombre_empresa));
+  }
+  
+  if (doc.containsKey("tcpipMode")) {
+    update.fields |= CONFIG_UPDATE_TCPIP_MODE;
+    next.modo_tcpip485 = doc["tcpipMode"];
+  }
+  
+  if (doc.containsKey("workMode")) {
+    update.fields |= CONFIG_UPDATE_WORK_MODE;
+    next.modo_work = doc["workMode"];
+  }
+  
+  if (doc.containsKey("displayMode")) {
+    update.fields |= CONFIG_UPDATE_DISPLAY_MODE;
+    next.modo_display = doc["displayMode"];
+  }
+  
+  if (doc.containsKey("qrMode")) {
+    update.fields |= CONFIG_UPDATE_QR_MODE;
+    next.modo_QR_8_12 = doc["qrMode"];
+  }
+  
+  if (doc.containsKey("clockMode")) {
+    update.fields |= CONFIG_UPDATE_CLOCK_MODE;
+    next.modo_clock = doc["clockMode"];
+  }
+  
+  if (doc.containsKey("sensorMode")) {
+    update.fields |= CONFIG_UPDATE_SENSOR_MODE;
+    next.modo_sens_altura = doc["sensorMode"];
+  }
+  
+  if (doc.containsKey("isEntrance")) {
+    update.fields |= CONFIG_UPDATE_ENTRANCE;
+    next.esPuertaEntrada = doc["isEntrance"];
+  }
+  
+  // Relés
+  if (doc.containsKey("relays")) {
+    JsonArray relaysArray = doc["relays"];
+    for (JsonObject relay : relaysArray) {
+      if (relay.containsKey("number") && relay.containsKey("time")) {
+        int number = relay["number"];
+        if (number >= 1 && number <= RELAY_COUNT) {
+          update.relayMask |= 1 << (number - 1);
+          update.relayTime[number - 1] = relay["time"];
+        }
+      }
+    }
+  }
+  
+  CommandResponse result = runConfigUpdate(update);
+  
+  // Preparar respuesta
+  char message[MESSAGE_TEXT_SIZE];
+  formatMessage(result, message, sizeof(message));
+  
+  StaticJsonDocument<128> respDoc;
+  respDoc["success"] = result.success;
+  respDoc["message"] = message;
+  respDoc["needsRestart"] = result.success && result.arg != 0;
+  if (commandPending(result)) respDoc["pending"] = true;
+  
+  serializeJson(respDoc, response);
+  return result.success;
+}
+
+// POST /api/sync - Confirmar en flash la configuración pendiente
+bool apiSync(Print& response) {
+  StaticJsonDocument<128> doc;
+  bool success = syncStorage();
+  
+  doc["success"] = success;
+  doc["message"] = success ? "Almacenamiento sincronizado" : "Error al sincronizar almacenamiento";
+  
+  serializeJson(doc, response);
+  return success;
+}
+
+// POST /api/reset - Reiniciar el dispositivo
+// Es el comando X0: el reinicio se difiere hasta después de responder
+bool apiReset(Print& response) {
+  StaticJsonDocument<128> doc;
+  char reply[API_REPLY_SIZE];
+  CommandResponse cmdResponse = runCommand("X0", reply, sizeof(reply));
+  
+  char message[MESSAGE_TEXT_SIZE];
+  formatMessage(cmdResponse, message, sizeof(message));
+  doc["success"] = cmdResponse.success;
+  doc["message"] = message;
+  if (commandPending(cmdResponse)) doc["pending"] = true;
+  
+  serializeJson(doc, response);
+  return cmdResponse.success;
+}
+
+// Manejadores para endpoints HTTP
+void handleApiStatus() {
+  StatusSnapshot snapshot;
+  readStatusSnapshot(snapshot);
+  sendCachedJson(statusCache, snapshot.version, 0, apiGetStatus);
+}
+
+void handleApiRelay() {
+  if (!server.hasArg("relay") || !server.hasArg("action")) {
+    server.send(400, "application/json", "{\"success\":false,\"message\":\"Parámetros faltantes\"}");
+    return;
+  }
+  
+  int relayNum = atoi(server.arg("relay"));
+  bool activate = strcmp(server.arg("action"), "activate") == 0;
+  
+  ArenaPrint response;
+  apiActivateRelay(relayNum, activate, response);
+  sendArenaJson(200, response);
+}
+
+void handleApiCommand() {
+  if (!server.hasArg("command")) {
+    server.send(400, "application/json", "{\"success\":false,\"message\":\"Parámetro 'command' requerido\"}");
+    return;
+  }
+  
+  ArenaPrint response;
+  apiSendCommand(server.arg("command"), response);
+  sendArenaJson(200, response);
+}
+
+void handleApiCommands() {
+  if (!server.hasArg("plain")) {
+    server.send(400, "application/json", "{\"success\":false,\"message\":\"Lista de comandos JSON requerida\"}");
+    return;
+  }
+  
+  // El lote se ejecuta solo si su respuesta tiene dónde quedar
+  ChunkedResponse response;
+  if (!response.beginLarge(200, "application/json")) return;
+  apiSendCommands(server.arg("plain"), response);
+  response.end();
+}
+
+void handleApiGetConfig() {
+  StatusSnapshot snapshot;
+  readStatusSnapshot(snapshot);
+  sendCachedJson(configCache, snapshot.configVersion, relayStateSignature(snapshot), apiGetConfig);
+}
+
+void handleApiSetConfig() {
+  if (!server.hasArg("plain")) {
+    server.send(400, "application/json", "{\"success\":false,\"message\":\"Configuración JSON requerida\"}");
+    return;
+  }
+  
+  ArenaPrint response;
+  apiSetConfig(server.arg("plain"), response);
+  sendArenaJson(200, response);
+}
+
+void handleApiReset() {
+  ArenaPrint response;
+  apiReset(response);
+  sendArenaJson(200, response);
+}
+
+void handleApiSync() {
+  ArenaPrint response;
+  bool success = apiSync(response);
+  sendArenaJson(success ? 200 : 500, response);
+}
+
+// GET /metrics - Contadores en formato de texto de Prometheus
+void handleMetrics() {
+  ChunkedResponse response;
+  if (!response.beginLarge(200, "text/plain; version=0.0.4")) return;
+  printMetrics(response);
+  response.end();
+}
+
+// GET /api/tasks - Tiempos de cada tarea del planificador
+void handleApiTasks() {
+  ChunkedResponse response;
+  response.begin(200, "application/json");
+  printSchedulerStats(response);
+  response.end();
+}
+
+// GET /api/memory - Margen de pilas y heap, RAM estática por subsistema
+void handleApiMemory() {
+  ChunkedResponse response;
+  response.begin(200, "application/json");
+  printMemoryReport(response);
+  response.end();
+}
+
+size_t getApiCacheRam() {
+  return sizeof(statusBody) + sizeof(configBody);
+}
+
+#endif
@@ -1,38 +1,59 @@
-// Actualiza el archivo apis.h con estas definiciones
-
-#ifndef APIS_H
-#define APIS_H
-
-#include "estructuras.h"
-#include <Arduino.h>
-
-// Configuración de la API
-void setupApi();
-void handleApiRequests();
-
-// Endpoints de API
-bool apiGetStatus(String& response);
-bool apiActivateRelay(int relayNum, bool activate, String& response);
-bool apiSendCommand(const String& command, String& response);
-bool apiGetConfig(String& response);
-bool apiSetConfig(const String& configJson, String& response);
-bool apiReset(String& response);
-
-// Conversiones para la API
-void statusToJson(const StatusInfo& status, String& json);
-void configToJson(const DeviceConfig& config, String& json);
-bool jsonToConfig(const String& json, DeviceConfig& config);
-
-// Endpoints HTTP
-void handleApiStatus();
-void handleApiRelay();
-void handleApiCommand();
-void handleApiGetConfig();
-void handleApiSetConfig();
-void handleApiReset();
-
-// Respuestas de API
-void sendApiResponse(bool success, const String& message, const String& data);
-void sendApiError(const String& errorMessage);
-
+// Actualiza el archivo apis.h con estas definiciones
+
+#ifndef APIS_H
+#define APIS_H
+
+#include "estructuras.h"
+#include <Arduino.h>
+
+// Tamaño de los buffers de la caché de respuestas JSON
+#define API_STATUS_CACHE_SIZE 320
+#define API_CONFIG_CACHE_SIZE 512
+
+// Respuesta del protocolo capturada para un comando REST
+#define API_REPLY_SIZE 80
+
+// Cantidad máxima de comandos en POST /api/commands
+#define API_MAX_BATCH_COMMANDS 16
+
+// Configuración de la API
+void setupApi();
+void handleApiRequests();
+
+// Endpoints de API
+bool apiGetStatus(Print& response);
+// Las respuestas se escriben en un Print (normalmente un ArenaPrint, arena.h)
+bool apiActivateRelay(int relayNum, bool activate, Print& response);
+bool apiSendCommand(const char* command, Print& response);
+bool apiSendCommands(const char* commandsJson, Print& response);
+bool apiGetConfig(Print& response);
+bool apiSetConfig(const char* configJson, Print& response);
+bool apiReset(Print& response);
+bool apiSync(Print& response);
+
+// Conversiones para la API
+void statusToJson(const StatusInfo& status, Print& json);
+void configToJson(const DeviceConfig& config, Print& json);
+bool jsonToConfig(const char* json, DeviceConfig& config);
+
+// Endpoints HTTP
+void handleApiStatus();
+void handleApiRelay();
+void handleApiCommand();
+void handleApiCommands();
+void handleApiGetConfig();
+void handleApiSetConfig();
+void handleApiReset();
+void handleApiSync();
+void handleApiTasks();
+void handleApiMemory();
+void handleMetrics();
+
+// RAM estática de la caché de respuestas (memoria.h)
+size_t getApiCacheRam();
+
+// Respuestas de API
+void sendApiResponse(bool success, const char* message, const char* data);
+void sendApiError(const char* errorMessage);
+
 #endif
\ No newline at end of file
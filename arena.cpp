@@ -0,0 +1,99 @@
+#include "arena.h"
+#include "perfil.h"
+#include <stdarg.h>
+
+// Solo en perfiles con servidor HTTP (perfil.h)
+#if PROFILE_HTTP
+
+RequestArena requestArena;
+
+RequestArena::RequestArena() : used(0), peak(0), overflows(0) {
+}
+
+void RequestArena::grew() {
+  if (used > peak) peak = used;
+}
+
+void* RequestArena::alloc(size_t size) {
+  size_t offset = (used + 3) & ~(size_t)3;
+  if (offset + size > sizeof(buffer)) {
+    overflows++;
+    return NULL;
+  }
+  
+  used = offset + size;
+  grew();
+  return (uint8_t*)buffer + offset;
+}
+
+const char* RequestArena::format(const char* fmt, ...) {
+  char* text = (char*)buffer + used;
+  size_t room = sizeof(buffer) - used;
+  
+  va_list args;
+  va_start(args, fmt);
+  int n = vsnprintf(text, room, fmt, args);
+  va_end(args);
+  
+  if (n < 0 || (size_t)n >= room) {
+    overflows++;
+    return "";
+  }
+  
+  used += n + 1;
+  grew();
+  return text;
+}
+
+void RequestArena::reset() {
+  used = 0;
+}
+
+size_t RequestArena::getPeak() {
+  return peak;
+}
+
+uint32_t RequestArena::getOverflows() {
+  return overflows;
+}
+
+// Texto al final de la arena
+ArenaPrint::ArenaPrint(RequestArena& arena)
+  : arena(arena), start((char*)arena.buffer + arena.used), len(0), overflow(false), closed(false) {
+}
+
+size_t ArenaPrint::write(uint8_t c) {
+  return write(&c, 1);
+}
+
+size_t ArenaPrint::write(const uint8_t* data, size_t n) {
+  // Siempre queda un byte libre para el '\0' de c_str()
+  if (closed || arena.used + n >= sizeof(arena.buffer)) {
+    if (!overflow) arena.overflows++;
+    overflow = true;
+    return 0;
+  }
+  
+  memcpy(start + len, data, n);
+  len += n;
+  arena.used += n;
+  arena.grew();
+  return n;
+}
+
+const char* ArenaPrint::c_str() {
+  if (!closed && arena.used >= sizeof(arena.buffer)) {
+    overflow = true; // Arena llena desde antes de empezar
+    return "";
+  }
+  
+  if (!closed) {
+    start[len] = '\0';
+    arena.used++;
+    arena.grew();
+    closed = true;
+  }
+  return start;
+}
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <Arduino.h>
+
+// Arena de cada pedido HTTP
+// Bloque fijo que se reparte en forma lineal mientras se atiende un pedido y se
+// libera entero cuando el servidor termina de despacharlo. El texto del pedido
+// (JSON de la API, mensajes de error) se arma acá en lugar de en String, así el
+// tráfico web no fragmenta el heap. Solo la usa la tarea web.
+
+#define REQUEST_ARENA_SIZE 1536     // Mayor respuesta de la API armada en RAM (lote de comandos aparte)
+
+class RequestArena {
+  public:
+    RequestArena();
+    
+    // Bloque alineado a 4 bytes; NULL si no hay lugar
+    void* alloc(size_t size);
+    
+    // Texto con formato de printf guardado en la arena ("" si no entra)
+    const char* format(const char* fmt, ...);
+    
+    // Liberar todo (HttpServer, al terminar cada pedido)
+    void reset();
+    
+    // Estadísticas para /metrics
+    size_t getPeak();
+    uint32_t getOverflows();
+    
+  private:
+    friend class ArenaPrint;
+    
+    void grew();
+    
+    uint32_t buffer[REQUEST_ARENA_SIZE / 4];   // uint32_t: alineación de alloc()
+    size_t used;
+    size_t peak;                                // Mayor uso desde el arranque
+    uint32_t overflows;                         // Pedidos que no entraron
+};
+
+extern RequestArena requestArena;
+
+// Texto que crece al final de la arena a medida que se escribe
+// Hasta llamar a c_str() no se debe pedir otro bloque a la misma arena
+class ArenaPrint : public Print {
+  public:
+    ArenaPrint(RequestArena& arena = requestArena);
+    
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* data, size_t len) override;
+    
+    const char* c_str();         // Cierra el texto con '\0'
+    size_t length() const { return len; }
+    bool overflowed() const { return overflow; }
+    
+  private:
+    RequestArena& arena;
+    char* start;
+    size_t len;
+    bool overflow;
+    bool closed;
+};
+
+#endif
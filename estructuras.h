@@ -1,52 +1,150 @@
-#ifndef ESTRUCTURAS_H
-#define ESTRUCTURAS_H
-
-#include <Arduino.h>
-
-// Estructura para la configuración del dispositivo
-typedef struct {
-    uint8_t deviceId;            // ID del dispositivo (0-255)
-    char deviceIdStr[3];         // ID en formato string (ej. "00")
-    char nombre_empresa[17];     // Nombre de la empresa (16 caracteres + null)
-    uint8_t modo_tcpip485;       // Modo de comunicación TCP/IP485
-    uint8_t modo_work;           // Modo de trabajo
-    uint8_t modo_display;        // Modo de pantalla
-    uint8_t modo_QR_8_12;        // Modo de lectura QR
-    uint8_t modo_clock;          // Modo reloj
-    uint8_t modo_sens_altura;    // Modo sensor de altura
-    bool esPuertaEntrada;        // True si es puerta de entrada, false si es salida
-} DeviceConfig;
-
-// Estructura para almacenar información del status
-typedef struct {
-    uint16_t status;             // Status actual (16 bits)
-    char statusHex[5];           // Status en formato hexadecimal (4 char + null)
-    char rfidData[16];           // Datos RFID o código leído
-    bool tarjetaLeida;           // Flag de lectura de tarjeta
-    bool pulsoDetectado;         // Flag de detección de pulso
-    bool scannerActivo;          // Flag de scanner activo
-} StatusInfo;
-
-// Estructura para respuestas de comandos
-typedef struct {
-    bool success;                // Si la operación fue exitosa
-    char message[64];            // Mensaje descriptivo
-    char data[128];              // Datos de respuesta (si los hay)
-} CommandResponse;
-
-// Estructura para buffer de comandos
-typedef struct {
-    char buffer[64];             // Buffer para comandos
-    uint8_t index;               // Índice actual en el buffer
-    bool complete;               // Si el comando está completo
-} CommandBuffer;
-
-// Estructura para la gestión de relés
-typedef struct {
-    uint8_t pin;                 // Pin GPIO
-    uint8_t state;               // Estado (0=OFF, 1=ON, otros valores especiales)
-    uint8_t time;                // Tiempo asociado (usado en algunos comandos)
-    uint16_t tmr_100ms;          // Timer interno (contador de 100ms)
-} RelayInfo;
-
+#ifndef ESTRUCTURAS_H
+#define ESTRUCTURAS_H
+
+#include <Arduino.h>
+#include "perfil.h"
+
+// Estructura para la configuración del dispositivo
+typedef struct {
+    uint8_t deviceId;            // ID del dispositivo (0-255)
+    char deviceIdStr[3];         // ID en formato string (ej. "00")
+    char nombre_empresa[17];     // Nombre de la empresa (16 caracteres + null)
+    uint8_t modo_tcpip485;       // Modo de comunicación TCP/IP485
+    uint8_t modo_work;           // Modo de trabajo
+    uint8_t modo_display;        // Modo de pantalla
+    uint8_t modo_QR_8_12;        // Modo de lectura QR
+    uint8_t modo_clock;          // Modo reloj
+    uint8_t modo_sens_altura;    // Modo sensor de altura
+    bool esPuertaEntrada;        // True si es puerta de entrada, false si es salida
+} DeviceConfig;
+
+// Estructura para almacenar información del status
+typedef struct {
+    uint16_t status;             // Status actual (16 bits)
+    char statusHex[5];           // Status en formato hexadecimal (4 char + null)
+    char rfidData[16];           // Datos RFID o código leído
+    bool tarjetaLeida;           // Flag de lectura de tarjeta
+    bool pulsoDetectado;         // Flag de detección de pulso
+    bool scannerActivo;          // Flag de scanner activo
+} StatusInfo;
+
+// Estructura para respuestas de comandos
+typedef struct {
+    bool success;                // Si la operación fue exitosa
+    uint8_t message;             // Mensaje del catálogo (mensajes.h)
+    uint16_t arg;                // Argumento del mensaje
+    char data[128];              // Datos de respuesta (si los hay)
+} CommandResponse;
+
+// Estructura para buffer de comandos
+typedef struct {
+    char buffer[64];             // Buffer para comandos
+    uint8_t index;               // Índice actual en el buffer
+    bool complete;               // Si el comando está completo
+    bool overflow;               // Se perdieron bytes por falta de espacio
+    bool endOnSib;               // SIB también cierra la trama (respuestas de datos)
+} CommandBuffer;
+
+// Estructura para la gestión de relés
+typedef struct {
+    uint8_t pin;                 // Pin GPIO
+    uint8_t state;               // Estado (0=OFF, 1=ON, otros valores especiales)
+    uint8_t time;                // Tiempo asociado (usado en algunos comandos)
+    uint16_t tmr_100ms;          // Timer interno (contador de 100ms)
+} RelayInfo;
+
+// Campos presentes en un ConfigUpdate
+#define CONFIG_UPDATE_DEVICE_ID    0x0001
+#define CONFIG_UPDATE_COMPANY      0x0002
+#define CONFIG_UPDATE_TCPIP_MODE   0x0004
+#define CONFIG_UPDATE_WORK_MODE    0x0008
+#define CONFIG_UPDATE_DISPLAY_MODE 0x0010
+#define CONFIG_UPDATE_QR_MODE      0x0020
+#define CONFIG_UPDATE_CLOCK_MODE   0x0040
+#define CONFIG_UPDATE_SENSOR_MODE  0x0080
+#define CONFIG_UPDATE_ENTRANCE     0x0100
+
+// Cambio de configuración pedido por la API (POST /api/config)
+// Lo aplica la tarea de protocolo, dueña de config y de los relés
+typedef struct {
+    uint16_t fields;             // CONFIG_UPDATE_* a aplicar
+    DeviceConfig config;         // Valores nuevos (solo los campos marcados)
+    uint8_t relayMask;           // Bit i: cambiar el tiempo del relé i + 1
+    uint8_t relayTime[RELAY_COUNT];
+} ConfigUpdate;
+
+// Motivos de descarte de tramas (índices de Metrics.framesDropped)
+#define DROP_INCOMPLETE        0   // Llegó un STX antes del ETX
+#define DROP_OVERFLOW          1   // Trama más larga que el buffer
+#define DROP_INVALID           2   // Sin STX/ETX o demasiado corta
+#define DROP_OTHER_DEVICE      3   // Dirigida a otro ID de dispositivo
+#define DROP_UNKNOWN_FUNCTION  4   // Código de función desconocido
+#define DROP_REASONS           5
+
+// Buckets del histograma de duración de loop() (límites en metricas.cpp)
+#define LOOP_BUCKETS 6
+
+// Contadores de métricas (se incrementan directamente en el camino crítico)
+typedef struct {
+    uint32_t framesReceived;                 // Tramas STX..ETX recibidas
+    uint32_t framesProcessed;                // Tramas despachadas a un procesador
+    uint32_t framesDropped[DROP_REASONS];    // Tramas descartadas por motivo
+    uint32_t ackSent;                        // ACK enviados
+    uint32_t nakSent;                        // NAK enviados
+    uint32_t commands[26];                   // Comandos por código de función (A-Z)
+    uint32_t relayActuations[RELAY_COUNT];   // Activaciones por relé
+    uint32_t storageCommits;                 // Commits de EEPROM a flash
+    uint32_t loopCount;                      // Vueltas de loop() medidas
+    uint64_t loopTotalUs;                    // Suma de duraciones de loop()
+    uint32_t loopMaxUs;                      // Máximo desde el arranque
+    uint32_t loopBuckets[LOOP_BUCKETS];      // Histograma (no acumulado)
+    uint32_t tcpAccepted;                    // Conexiones TCP del protocolo aceptadas
+    uint32_t gatewayRequests;                // Tramas recibidas por la pasarela
+    uint32_t gatewayCoalesced;               // Tramas que compartieron una transacción
+    uint32_t gatewayTimeouts;                // Transacciones sin respuesta del equipo
+} Metrics;
+
+// Tarea del planificador cooperativo (ver planificador.h)
+typedef struct {
+    const char* name;            // Nombre para /api/tasks
+    void (*run)();               // Función de la tarea
+    uint32_t periodUs;           // Período (0 = en cada pasada)
+    uint32_t budgetUs;           // Tiempo máximo esperado por ejecución
+    uint32_t lastRunUs;          // Inicio del período en curso
+    uint32_t runs;               // Ejecuciones
+    uint32_t overruns;           // Ejecuciones que superaron budgetUs
+    uint32_t lastUs;             // Duración de la última ejecución
+    uint32_t maxUs;              // Peor duración
+    uint64_t totalUs;            // Suma de duraciones
+    uint32_t maxLateUs;          // Peor demora respecto del período
+} SchedulerTask;
+
+// Bloque de configuración persistente (se guarda como una unidad en EEPROM)
+typedef struct __attribute__((packed)) {
+    uint16_t magic;              // Marca de bloque grabado (CONFIG_BLOCK_MAGIC)
+    uint8_t version;             // Versión del esquema (CONFIG_BLOCK_VERSION)
+    uint16_t length;             // Tamaño del bloque en bytes
+    uint8_t deviceId;            // ID del dispositivo
+    char nombre_empresa[17];     // Nombre de la empresa (16 caracteres + null)
+    uint8_t modo_tcpip485;       // Modo de comunicación TCP/IP485
+    uint8_t modo_work;           // Modo de trabajo
+    uint8_t modo_display;        // Modo de pantalla
+    uint8_t modo_QR_8_12;        // Modo de lectura QR
+    uint8_t modo_clock;          // Modo reloj
+    uint8_t modo_sens_altura;    // Modo sensor de altura
+    uint8_t relayTime[5];        // Tiempos de los relés
+    uint8_t ddmmTime[4];         // Tiempos presencia/ausencia DDMM1 y DDMM2
+    char ticketLine[4][17];      // Líneas del ticket (16 caracteres + null)
+    uint8_t serialNumber[5];     // Bytes del número de serie
+    uint16_t crc;                // CRC16 de todos los campos anteriores
+} ConfigBlock;
+
+// Registro del log del contador de tickets (12 bytes, alineado a 4 para flash)
+typedef struct {
+    uint32_t sequence;           // Número de secuencia (crece con cada registro)
+    uint32_t counter;            // Valor del contador de tickets
+    uint16_t crc;                // CRC16 de sequence + counter
+    uint16_t marker;             // Marca de registro escrito (TICKET_LOG_MARKER)
+} TicketLogRecord;
+
 #endif
\ No newline at end of file
@@ -0,0 +1,91 @@
+#include "Arduino.h"
+#include "EEPROM.h"
+#include "flash_emulada.h"
+#include "flash_hal.h"
+
+HostSerial Serial;
+HostSerial Serial1;
+EspClass ESP;
+EEPROMClass EEPROM;
+
+// Tiempo
+unsigned long millis() {
+  return (unsigned long)(hostMicros() / 1000);
+}
+
+unsigned long micros() {
+  return (unsigned long)hostMicros();
+}
+
+void delay(unsigned long ms) {
+  hostAvanzarUs((uint64_t)ms * 1000);
+}
+
+void yield() {
+  hostAvanzarUs(1);
+}
+
+void pinMode(uint8_t, uint8_t) {}
+void digitalWrite(uint8_t, uint8_t) {}
+
+long random(long min, long max) {
+  return min + rand() % (max - min);
+}
+
+// Flash
+bool EspClass::flashEraseSector(uint32_t sector) {
+  return flashEmuladaBorrarSector(sector);
+}
+
+bool EspClass::flashWrite(uint32_t address, uint32_t* data, size_t size) {
+  if ((address & 3) || (size & 3)) return false; // El SDK exige alineación a 4
+  
+  flashStats.bytesLogicos += size;
+  return flashEmuladaEscribir(address, data, size);
+}
+
+bool EspClass::flashRead(uint32_t address, uint32_t* data, size_t size) {
+  return flashEmuladaLeer(address, data, size);
+}
+
+// EEPROM
+void EEPROMClass::begin(size_t size) {
+  end();
+  
+  _size = (size + 3) & ~3;
+  _data = new uint8_t[_size];
+  flashEmuladaLeer(EEPROM_PHYS_ADDR, _data, _size);
+  _dirty = false;
+}
+
+void EEPROMClass::end() {
+  delete[] _data;
+  _data = NULL;
+  _size = 0;
+}
+
+uint8_t EEPROMClass::read(int address) {
+  if (address < 0 || (size_t)address >= _size) return 0;
+  return _data[address];
+}
+
+void EEPROMClass::write(int address, uint8_t value) {
+  if (address < 0 || (size_t)address >= _size) return;
+  if (_data[address] == value) return;
+  
+  _data[address] = value;
+  _dirty = true;
+  flashStats.bytesLogicos++;
+}
+
+bool EEPROMClass::commit() {
+  if (!_dirty) return true;
+  
+  // Igual que el SDK: borrar el sector completo y reprogramar la copia
+  if (!flashEmuladaBorrarSector(EEPROM_PHYS_ADDR / FLASH_SECTOR_SIZE)) return false;
+  if (!flashEmuladaEscribir(EEPROM_PHYS_ADDR, _data, _size)) return false;
+  
+  flashStats.commits++;
+  _dirty = false;
+  return true;
+}
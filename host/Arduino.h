@@ -0,0 +1,88 @@
+#ifndef ARDUINO_HOST_H
+#define ARDUINO_HOST_H
+
+// Subconjunto del núcleo Arduino ESP8266 para compilar en el host
+// Solo lo que usan almacenamiento.cpp, utilidades.cpp y variables.cpp
+// (incluidos sus encabezados: BufferPrint y LOG_SERIAL)
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+
+using std::min;
+using std::max;
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+
+// Pines de la placa NodeMCU
+enum { D0 = 16, D1 = 5, D2 = 4, D3 = 0, D4 = 2, D5 = 14, D6 = 12, D7 = 13, D8 = 15, RX = 3, TX = 1 };
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void yield();
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+long random(long min, long max);
+
+// Salida con formato, igual que la clase Print del núcleo (solo lo usado)
+class Print {
+  public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    
+    virtual size_t write(const uint8_t* buffer, size_t size) {
+      size_t n = 0;
+      while (size--) n += write(*buffer++);
+      return n;
+    }
+    
+    size_t write(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+    size_t print(const char* s) { return write(s); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(unsigned long value) { return printNumber("%lu", value); }
+    size_t print(long value) { return printNumber("%ld", value); }
+    size_t print(unsigned int value) { return print((unsigned long)value); }
+    size_t print(int value) { return print((long)value); }
+    size_t println(const char* s) { return print(s) + println(); }
+    size_t println() { return print("\r\n"); }
+    
+  private:
+    template <typename T>
+    size_t printNumber(const char* format, T value) {
+      char buffer[24];
+      snprintf(buffer, sizeof(buffer), format, value);
+      return print(buffer);
+    }
+};
+
+// Salidas serie: se redirigen a stderr
+class HostSerial : public Print {
+  public:
+    void begin(unsigned long) {}
+    size_t write(uint8_t c) override { return fputc(c, stderr) == EOF ? 0 : 1; }
+    using Print::write;
+};
+
+extern HostSerial Serial;
+extern HostSerial Serial1;
+
+// Acceso a flash del ESP8266, sobre la flash emulada
+class EspClass {
+  public:
+    bool flashEraseSector(uint32_t sector);
+    bool flashWrite(uint32_t address, uint32_t* data, size_t size);
+    bool flashRead(uint32_t address, uint32_t* data, size_t size);
+    void restart() {}
+    void wdtDisable() {}
+};
+
+extern EspClass ESP;
+
+#endif
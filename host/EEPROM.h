@@ -0,0 +1,46 @@
+#ifndef EEPROM_HOST_H
+#define EEPROM_HOST_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+// EEPROM emulada con la misma semántica que la del núcleo ESP8266:
+// una copia en RAM de un sector de flash; commit() borra el sector y lo
+// reescribe completo, y solo si algún byte cambió.
+class EEPROMClass {
+  public:
+    EEPROMClass() {}
+    #ifdef ESP32
+      explicit EEPROMClass(const char* name) {}   // Espacio NVS del núcleo ESP32
+    #endif
+    
+    void begin(size_t size);
+    void end();
+    uint8_t read(int address);
+    void write(int address, uint8_t value);
+    bool commit();
+    size_t length() { return _size; }
+    uint8_t* getDataPtr() { _dirty = true; return _data; }
+    
+    template<typename T> T& get(int address, T& t) {
+      if (address < 0 || address + sizeof(T) > _size) return t;
+      memcpy((uint8_t*)&t, _data + address, sizeof(T));
+      return t;
+    }
+    
+    template<typename T> const T& put(int address, const T& t) {
+      if (address < 0 || address + sizeof(T) > _size) return t;
+      for (size_t i = 0; i < sizeof(T); i++) write(address + i, ((const uint8_t*)&t)[i]);
+      return t;
+    }
+    
+  private:
+    uint8_t* _data = NULL;
+    size_t _size = 0;
+    bool _dirty = false;
+};
+
+extern EEPROMClass EEPROM;
+
+#endif
@@ -0,0 +1,179 @@
+// Banco de pruebas de desgaste de flash para almacenamiento.cpp
+//
+// Compila el módulo de almacenamiento real contra la EEPROM y la flash
+// emuladas del host y mide, para cargas de trabajo típicas, cuántos commits,
+// borrados de sector y bytes físicos cuesta cada cambio lógico.
+// Termina con código 1 si alguna carga supera su límite (regresión de desgaste).
+//
+// Desde la raíz del repositorio:
+//   g++ -std=gnu++17 -O2 -DESP8266 -Ihost -I. host/*.cpp almacenamiento.cpp utilidades.cpp variables.cpp -o banco_almacenamiento
+//   ./banco_almacenamiento [archivo_flash]
+//
+// La rama ESP32 solo se compila (tarea de escritura y partición del log):
+//   g++ -std=gnu++17 -fsyntax-only -DESP32 -Ihost -I. almacenamiento.cpp
+
+#include "Arduino.h"
+#include "EEPROM.h"
+#include "flash_emulada.h"
+#include "../almacenamiento.h"
+#include "../variables.h"
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define EEPROM_SIZE 512
+
+static int fallas = 0;
+
+// Resultado de una carga de trabajo
+static void informar(const char* nombre, uint32_t maxCommits, uint32_t maxBorradosSector) {
+  uint32_t peorSector = 0;
+  for (uint32_t i = 0; i < FLASH_EMULADA_SECTORES; i++) {
+    if (flashStats.borradosPorSector[i] > peorSector) peorSector = flashStats.borradosPorSector[i];
+  }
+  
+  uint64_t fisicos = flashStats.bytesProgramados + (uint64_t)flashStats.sectoresBorrados * FLASH_EMULADA_SECTOR;
+  double amplificacion = flashStats.bytesLogicos ? (double)fisicos / flashStats.bytesLogicos : 0.0;
+  bool ok = flashStats.commits <= maxCommits && peorSector <= maxBorradosSector &&
+            flashStats.escriturasInvalidas == 0;
+  
+  printf("%-28s %8u %10u %10u %9u %11u %9.1f %10.1f  %s\n",
+         nombre, flashStats.commits, flashStats.bytesLogicos, flashStats.bytesProgramados,
+         flashStats.sectoresBorrados, peorSector, amplificacion,
+         flashStats.bloqueoUs / 1000.0, ok ? "OK" : "FALLA");
+  
+  if (!ok) fallas++;
+  flashEmuladaResetStats();
+}
+
+// Dejar pasar tiempo ocioso para que se confirmen las escrituras diferidas
+static void esperarOcioso(unsigned long ms) {
+  delay(ms);
+  storageLoop();
+}
+
+static void arrancar() {
+  EEPROM.begin(EEPROM_SIZE);
+  initStorage();
+  readConfigFromEEPROM();
+}
+
+// Un corte de energía no debe hacer que se repitan números de ticket
+static void verificarReinicio() {
+  int fds[2];
+  if (pipe(fds) != 0) return;
+  
+  uint32_t ultimo = 0, primero = 0;
+  
+  // Primer arranque: emite tickets y se corta sin apagado ordenado
+  if (fork() == 0) {
+    arrancar();
+    for (int i = 0; i < 100; i++) ultimo = issueTicketNumber();
+    if (write(fds[1], &ultimo, sizeof(ultimo)) != sizeof(ultimo)) _exit(1);
+    _exit(0);
+  }
+  wait(NULL);
+  
+  // Segundo arranque: el primer número tiene que ser mayor que el último emitido
+  if (fork() == 0) {
+    arrancar();
+    primero = issueTicketNumber();
+    if (write(fds[1], &primero, sizeof(primero)) != sizeof(primero)) _exit(1);
+    _exit(0);
+  }
+  wait(NULL);
+  
+  bool ok = read(fds[0], &ultimo, sizeof(ultimo)) == sizeof(ultimo) &&
+            read(fds[0], &primero, sizeof(primero)) == sizeof(primero) &&
+            primero > ultimo;
+  
+  printf("Reinicio inesperado: último ticket %u, siguiente tras reiniciar %u  %s\n\n",
+         ultimo, primero, ok ? "OK" : "FALLA");
+  if (!ok) fallas++;
+  
+  close(fds[0]);
+  close(fds[1]);
+}
+
+int main(int argc, char** argv) {
+  const char* path = argc > 1 ? argv[1] : "flash_emulada.bin";
+  
+  if (!flashEmuladaAbrir(path, true)) {
+    fprintf(stderr, "No se pudo abrir %s\n", path);
+    return 2;
+  }
+  
+  verificarReinicio();
+  
+  // Flash nueva para las mediciones
+  flashEmuladaCerrar();
+  flashEmuladaAbrir(path, true);
+  
+  printf("%-28s %8s %10s %10s %9s %11s %9s %10s\n",
+         "Carga", "Commits", "B.logicos", "B.program.", "Borrados", "Max/sector", "Amplif.", "Bloqueo ms");
+  
+  arrancar();
+  syncStorage();
+  informar("Arranque (migracion)", 1, 1);
+  
+  // Aprovisionamiento de un carril, como lo hace apiSetConfig
+  beginStorageTransaction();
+  saveCompanyName("PARKING CENTRO");
+  saveTicketLine(1, "PARKING CENTRO  ");
+  saveTicketLine(2, "AV. SIEMPREVIVA ");
+  saveTicketLine(3, "TARIFA HORA $100");
+  saveTicketLine(4, "GRACIAS         ");
+  saveTcpIpMode(1);
+  saveWorkMode(2);
+  saveDisplayMode(1);
+  saveQRMode(1);
+  saveClockMode(1);
+  saveSensorMode(1);
+  for (int relay = 1; relay <= 5; relay++) saveRelayTimer(relay, 3 + relay);
+  commitStorageTransaction();
+  esperarOcioso(1000);
+  informar("Aprovisionamiento", 1, 1);
+  
+  // La misma configuración otra vez: nada cambió, no debe tocar la flash
+  beginStorageTransaction();
+  saveCompanyName("PARKING CENTRO");
+  for (int relay = 1; relay <= 5; relay++) saveRelayTimer(relay, 3 + relay);
+  commitStorageTransaction();
+  esperarOcioso(1000);
+  informar("Reaprovisionar sin cambios", 0, 0);
+  
+  // Comandos sueltos en ráfaga (T4-T7 seguidos desde el maestro)
+  for (int line = 1; line <= 4; line++) {
+    char text[17];
+    snprintf(text, sizeof(text), "RAFAGA LINEA %d  ", line);
+    saveTicketLine(line, text);
+    esperarOcioso(20);
+  }
+  esperarOcioso(1000);
+  informar("Rafaga T4-T7", 1, 1);
+  
+  // Ajustes de tiempo de relé espaciados (uno por segundo)
+  for (int i = 0; i < 100; i++) {
+    saveRelayTimer((i % 5) + 1, 1 + (i % 90));
+    esperarOcioso(1000);
+  }
+  informar("100 tiempos de rele", 100, 100);
+  
+  // 10.000 tickets, uno por segundo
+  uint32_t anterior = issueTicketNumber();
+  bool secuencial = true;
+  for (int i = 1; i < 10000; i++) {
+    uint32_t numero = issueTicketNumber();
+    if (numero != anterior + 1) secuencial = false;
+    anterior = numero;
+    esperarOcioso(1000);
+  }
+  informar("10.000 tickets", 0, 1);
+  
+  if (!secuencial) {
+    printf("Numeración de tickets no secuencial  FALLA\n");
+    fallas++;
+  }
+  
+  flashEmuladaCerrar();
+  return fallas ? 1 : 0;
+}
@@ -0,0 +1,35 @@
+#ifndef ESP_PARTITION_HOST_H
+#define ESP_PARTITION_HOST_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Particiones del ESP-IDF (solo lo que usa almacenamiento.cpp)
+// Solo declaraciones: permiten compilar la rama ESP32 en el host (-DESP32),
+// el banco se enlaza y se ejecuta con -DESP8266
+
+typedef int esp_err_t;
+#define ESP_OK 0
+
+typedef enum {
+  ESP_PARTITION_TYPE_DATA = 0x01
+} esp_partition_type_t;
+
+typedef enum {
+  ESP_PARTITION_SUBTYPE_DATA_SPIFFS = 0x82
+} esp_partition_subtype_t;
+
+typedef struct {
+  esp_partition_type_t type;
+  esp_partition_subtype_t subtype;
+  uint32_t address;
+  uint32_t size;
+  char label[17];
+} esp_partition_t;
+
+const esp_partition_t* esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype, const char* label);
+esp_err_t esp_partition_read(const esp_partition_t* partition, size_t srcOffset, void* dst, size_t size);
+esp_err_t esp_partition_write(const esp_partition_t* partition, size_t dstOffset, const void* src, size_t size);
+esp_err_t esp_partition_erase_range(const esp_partition_t* partition, size_t offset, size_t size);
+
+#endif
@@ -0,0 +1,89 @@
+#include "flash_emulada.h"
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+FlashStats flashStats;
+
+static uint8_t* flash = NULL;
+static int flashFd = -1;
+static uint64_t relojUs = 0;
+
+bool flashEmuladaAbrir(const char* path, bool borrar) {
+  flashFd = open(path, O_RDWR | O_CREAT | (borrar ? O_TRUNC : 0), 0644);
+  if (flashFd < 0) return false;
+  
+  // Un archivo nuevo (o truncado) se inicializa como flash borrada
+  off_t size = lseek(flashFd, 0, SEEK_END);
+  if (size != FLASH_EMULADA_SIZE && ftruncate(flashFd, FLASH_EMULADA_SIZE) != 0) return false;
+  
+  void* map = mmap(NULL, FLASH_EMULADA_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, flashFd, 0);
+  if (map == MAP_FAILED) return false;
+  
+  flash = (uint8_t*)map;
+  if (size != FLASH_EMULADA_SIZE) memset(flash, 0xFF, FLASH_EMULADA_SIZE);
+  
+  flashEmuladaResetStats();
+  return true;
+}
+
+void flashEmuladaCerrar() {
+  if (flash != NULL) {
+    msync(flash, FLASH_EMULADA_SIZE, MS_SYNC);
+    munmap(flash, FLASH_EMULADA_SIZE);
+    flash = NULL;
+  }
+  if (flashFd >= 0) {
+    close(flashFd);
+    flashFd = -1;
+  }
+}
+
+void flashEmuladaResetStats() {
+  memset(&flashStats, 0, sizeof(flashStats));
+}
+
+bool flashEmuladaLeer(uint32_t address, void* data, size_t size) {
+  if (flash == NULL || address + size > FLASH_EMULADA_SIZE) return false;
+  
+  memcpy(data, flash + address, size);
+  return true;
+}
+
+bool flashEmuladaEscribir(uint32_t address, const void* data, size_t size) {
+  if (flash == NULL || address + size > FLASH_EMULADA_SIZE) return false;
+  
+  // La programación solo puede pasar bits de 1 a 0 (igual que el hardware)
+  const uint8_t* src = (const uint8_t*)data;
+  for (size_t i = 0; i < size; i++) {
+    if ((flash[address + i] & src[i]) != src[i]) flashStats.escriturasInvalidas++;
+    flash[address + i] &= src[i];
+  }
+  
+  flashStats.bytesProgramados += size;
+  flashStats.bloqueoUs += (uint64_t)size * FLASH_PROGRAM_US_BYTE;
+  hostAvanzarUs((uint64_t)size * FLASH_PROGRAM_US_BYTE);
+  return true;
+}
+
+bool flashEmuladaBorrarSector(uint32_t sector) {
+  if (flash == NULL || sector >= FLASH_EMULADA_SECTORES) return false;
+  
+  memset(flash + sector * FLASH_EMULADA_SECTOR, 0xFF, FLASH_EMULADA_SECTOR);
+  
+  flashStats.sectoresBorrados++;
+  flashStats.borradosPorSector[sector]++;
+  flashStats.bloqueoUs += FLASH_ERASE_US;
+  hostAvanzarUs(FLASH_ERASE_US);
+  return true;
+}
+
+// Reloj simulado
+void hostAvanzarUs(uint64_t us) {
+  relojUs += us;
+}
+
+uint64_t hostMicros() {
+  return relojUs;
+}
@@ -0,0 +1,46 @@
+#ifndef FLASH_EMULADA_H
+#define FLASH_EMULADA_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Flash SPI emulada para compilar almacenamiento.cpp en el host
+// Respaldada por un archivo mapeado en memoria con la semántica real:
+// el borrado es por sector (todo a 0xFF) y la programación solo pasa bits a 0.
+
+#define FLASH_EMULADA_SIZE      0x400000  // 4 MB, como un ESP-12
+#define FLASH_EMULADA_SECTOR    0x1000    // 4 KB
+#define FLASH_EMULADA_SECTORES  (FLASH_EMULADA_SIZE / FLASH_EMULADA_SECTOR)
+
+// Tiempos típicos de una flash SPI (W25Q32) para estimar bloqueos
+#define FLASH_ERASE_US          45000     // Borrado de un sector
+#define FLASH_PROGRAM_US_BYTE   3         // Programación (~0,7 ms por página de 256 bytes)
+
+// Contadores de desgaste y costo
+typedef struct {
+    uint32_t commits;                     // EEPROM.commit() que llegaron a flash
+    uint32_t bytesLogicos;                // Bytes que la aplicación cambió de valor
+    uint32_t bytesProgramados;            // Bytes escritos físicamente
+    uint32_t sectoresBorrados;            // Borrados totales
+    uint64_t bloqueoUs;                   // Tiempo simulado con la CPU bloqueada
+    uint32_t escriturasInvalidas;         // Programaciones que pedían pasar bits de 0 a 1
+    uint32_t borradosPorSector[FLASH_EMULADA_SECTORES];
+} FlashStats;
+
+extern FlashStats flashStats;
+
+// Abrir (o crear borrado) el archivo de respaldo
+bool flashEmuladaAbrir(const char* path, bool borrar);
+void flashEmuladaCerrar();
+void flashEmuladaResetStats();
+
+// Operaciones de bajo nivel (direcciones absolutas dentro de la flash)
+bool flashEmuladaLeer(uint32_t address, void* data, size_t size);
+bool flashEmuladaEscribir(uint32_t address, const void* data, size_t size);
+bool flashEmuladaBorrarSector(uint32_t sector);
+
+// Reloj simulado (millis/micros del host)
+void hostAvanzarUs(uint64_t us);
+uint64_t hostMicros();
+
+#endif
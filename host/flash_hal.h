@@ -0,0 +1,11 @@
+#ifndef FLASH_HAL_HOST_H
+#define FLASH_HAL_HOST_H
+
+// Esquema de flash "4MB (FS:2MB OTA:~1019KB)" del núcleo ESP8266
+// La EEPROM emulada ocupa el sector siguiente al final del área FS
+#define FLASH_SECTOR_SIZE   0x1000
+#define FS_PHYS_ADDR        0x200000
+#define FS_PHYS_SIZE        0x1FA000
+#define EEPROM_PHYS_ADDR    (FS_PHYS_ADDR + FS_PHYS_SIZE)
+
+#endif
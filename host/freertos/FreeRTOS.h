@@ -0,0 +1,19 @@
+#ifndef FREERTOS_HOST_H
+#define FREERTOS_HOST_H
+
+#include <stdint.h>
+
+// Tipos de FreeRTOS (solo lo que usa almacenamiento.cpp)
+// Solo declaraciones para compilar la rama ESP32 en el host (-DESP32)
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+
+#define pdTRUE              1
+#define pdPASS              1
+#define portMAX_DELAY       ((TickType_t)0xFFFFFFFF)
+#define pdMS_TO_TICKS(ms)   ((TickType_t)(ms))
+#define tskIDLE_PRIORITY    0
+
+#endif
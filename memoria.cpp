@@ -0,0 +1,203 @@
+#include "memoria.h"
+#include "variables.h"
+#include "servidor.h"
+#include "arena.h"
+#include "apis.h"
+#include "protocolo.h"
+#include "almacenamiento.h"
+#include "tareas.h"
+#include "transporte_tcp.h"
+#include "pasarela.h"
+
+#ifdef ESP32
+  #include <freertos/FreeRTOS.h>
+  #include <freertos/task.h>
+#endif
+
+// Pila de loop(): cont del core en ESP8266, loopTask en ESP32
+#ifdef ESP8266
+  #define LOOP_STACK_SIZE 4096
+#elif defined(ESP32)
+  #ifdef CONFIG_ARDUINO_LOOP_STACK_SIZE
+    #define LOOP_STACK_SIZE CONFIG_ARDUINO_LOOP_STACK_SIZE
+  #else
+    #define LOOP_STACK_SIZE 8192
+  #endif
+#endif
+
+MemoryStats memoryStats;
+
+static const char* stackNames[MEMORY_STACKS] = {"loop", "protocol", "web"};
+
+// RAM estática de cada subsistema y el máximo que se le permite
+typedef struct {
+  const char* name;
+  size_t (*bytes)();
+  size_t budget;
+} RamBudget;
+
+#if PROFILE_HTTP
+  static size_t httpRam() {
+    return sizeof(server);
+  }
+  
+  static size_t arenaRam() {
+    return sizeof(requestArena);
+  }
+#endif
+
+static size_t stateRam() {
+  return sizeof(config) + sizeof(statusInfo) + sizeof(relays) + sizeof(metrics) + sizeof(memoryStats);
+}
+
+// Solo los subsistemas que compila el perfil (perfil.h)
+static const RamBudget ramBudgets[] = {
+  #if PROFILE_HTTP
+    {"http", httpRam, 20480},
+    {"arena", arenaRam, 2048},
+  #endif
+  #if PROFILE_REST_API
+    {"apiCache", getApiCacheRam, 1024},
+  #endif
+  {"protocol", getProtocolRam, 1024},
+  {"tasks", getTaskQueuesRam, 2048},
+  #if PROFILE_TCP
+    {"tcp", getProtocolTcpRam, 1536},
+  #endif
+  #if PROFILE_GATEWAY
+    {"gateway", getGatewayRam, 2048},
+  #endif
+  {"storage", getStorageRam, 256},
+  {"state", stateRam, 512},
+};
+
+#define RAM_BUDGETS (sizeof(ramBudgets) / sizeof(ramBudgets[0]))
+
+void sampleHeap() {
+  uint32_t heapFree = ESP.getFreeHeap();
+  #ifdef ESP8266
+    uint32_t heapMaxBlock = ESP.getMaxFreeBlockSize();
+  #elif defined(ESP32)
+    uint32_t heapMaxBlock = ESP.getMaxAllocHeap();
+  #endif
+  
+  memoryStats.heapFree = heapFree;
+  memoryStats.heapMaxBlock = heapMaxBlock;
+  if (memoryStats.heapFreeMin == 0 || heapFree < memoryStats.heapFreeMin) memoryStats.heapFreeMin = heapFree;
+  if (memoryStats.heapMaxBlockMin == 0 || heapMaxBlock < memoryStats.heapMaxBlockMin) memoryStats.heapMaxBlockMin = heapMaxBlock;
+}
+
+#ifdef ESP32
+  // Los nombres se buscan una vez; la tarea puede no existir todavía
+  static uint32_t taskStackFree(const char* name, TaskHandle_t& handle) {
+    if (handle == NULL) handle = xTaskGetHandle(name);
+    if (handle == NULL) return 0;
+    return uxTaskGetStackHighWaterMark(handle); // En bytes en ESP-IDF
+  }
+#endif
+
+// Mínimo libre de cada pila; el núcleo ya guarda el más bajo, aquí solo se copia
+static void sampleStacks() {
+  memoryStats.stackSize[STACK_LOOP] = LOOP_STACK_SIZE;
+  
+  #ifdef ESP8266
+    memoryStats.stackFreeMin[STACK_LOOP] = ESP.getFreeContStack();
+  #elif defined(ESP32)
+    static TaskHandle_t loopHandle = NULL;
+    static TaskHandle_t protocolHandle = NULL;
+    static TaskHandle_t webHandle = NULL;
+    
+    memoryStats.stackFreeMin[STACK_LOOP] = taskStackFree("loopTask", loopHandle);
+    memoryStats.stackFreeMin[STACK_PROTOCOL] = taskStackFree(PROTOCOL_TASK_NAME, protocolHandle);
+    memoryStats.stackFreeMin[STACK_WEB] = taskStackFree(WEB_TASK_NAME, webHandle);
+    memoryStats.stackSize[STACK_PROTOCOL] = protocolHandle != NULL ? PROTOCOL_TASK_STACK : 0;
+    memoryStats.stackSize[STACK_WEB] = webHandle != NULL ? WEB_TASK_STACK : 0;
+  #endif
+}
+
+const char* getStackName(uint8_t stack) {
+  return stack < MEMORY_STACKS ? stackNames[stack] : "";
+}
+
+void sampleMemory() {
+  sampleHeap();
+  sampleStacks();
+}
+
+uint32_t getHeapFragmentation() {
+  #ifdef ESP8266
+    return ESP.getHeapFragmentation();
+  #elif defined(ESP32)
+    uint32_t heapFree = ESP.getFreeHeap();
+    if (heapFree == 0) return 0;
+    return 100 - (uint32_t)((uint64_t)ESP.getMaxAllocHeap() * 100 / heapFree);
+  #endif
+}
+
+void formatMemorySummary(char* out, size_t size) {
+  snprintf(out, size, "%lu,%lu,%lu,%lu,%lu,%lu",
+           (unsigned long)memoryStats.stackFreeMin[STACK_LOOP],
+           (unsigned long)memoryStats.stackFreeMin[STACK_PROTOCOL],
+           (unsigned long)memoryStats.stackFreeMin[STACK_WEB],
+           (unsigned long)memoryStats.heapFree,
+           (unsigned long)memoryStats.heapFreeMin,
+           (unsigned long)memoryStats.heapMaxBlockMin);
+}
+
+static void printField(Print& out, const char* name, uint32_t value, bool last = false) {
+  out.print("\"");
+  out.print(name);
+  out.print("\":");
+  out.print((unsigned long)value);
+  if (!last) out.print(",");
+}
+
+void printMemoryReport(Print& out) {
+  out.print("{\"heap\":{");
+  printField(out, "free", memoryStats.heapFree);
+  printField(out, "freeMin", memoryStats.heapFreeMin);
+  printField(out, "maxBlock", memoryStats.heapMaxBlock);
+  printField(out, "maxBlockMin", memoryStats.heapMaxBlockMin);
+  printField(out, "fragmentation", getHeapFragmentation(), true);
+  
+  // Solo las pilas que existen en esta placa
+  out.print("},\"stacks\":[");
+  bool first = true;
+  for (uint8_t i = 0; i < MEMORY_STACKS; i++) {
+    if (memoryStats.stackSize[i] == 0) continue;
+    
+    if (!first) out.print(",");
+    first = false;
+    out.print("{\"name\":\"");
+    out.print(getStackName(i));
+    out.print("\",");
+    printField(out, "size", memoryStats.stackSize[i]);
+    printField(out, "freeMin", memoryStats.stackFreeMin[i], true);
+    out.print("}");
+  }
+  
+  out.print("],\"ram\":[");
+  size_t total = 0;
+  size_t budget = 0;
+  uint8_t over = 0;
+  for (uint8_t i = 0; i < RAM_BUDGETS; i++) {
+    size_t bytes = ramBudgets[i].bytes();
+    total += bytes;
+    budget += ramBudgets[i].budget;
+    if (bytes > ramBudgets[i].budget) over++;
+    
+    if (i > 0) out.print(",");
+    out.print("{\"name\":\"");
+    out.print(ramBudgets[i].name);
+    out.print("\",");
+    printField(out, "bytes", bytes);
+    printField(out, "budget", ramBudgets[i].budget, true);
+    out.print("}");
+  }
+  
+  out.print("],");
+  printField(out, "ramTotal", total);
+  printField(out, "ramBudget", budget);
+  printField(out, "overBudget", over, true);
+  out.print("}");
+}
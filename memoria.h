@@ -0,0 +1,52 @@
+#ifndef MEMORIA_H
+#define MEMORIA_H
+
+#include <Arduino.h>
+
+// Presupuesto de memoria
+// Mide cuánto margen queda en cada pila y en el heap, y cuánta RAM estática
+// ocupa cada subsistema frente a su presupuesto. Las pilas vienen pintadas
+// desde el arranque (ESP8266: la de loop() con CONT_STACKGUARD; ESP32: las de
+// FreeRTOS con 0xA5), así que el mínimo libre es la parte que nunca se tocó.
+// Una tarea del planificador toma las muestras; el informe sale por V1 y por
+// GET /api/memory.
+
+#define MEMORY_SAMPLE_MS  1000    // Período de sampleMemory()
+
+// Pilas medidas
+#define STACK_LOOP        0       // loop() (cont en ESP8266, loopTask en ESP32)
+#define STACK_PROTOCOL    1       // Tarea de protocolo (solo ESP32)
+#define STACK_WEB         2       // Tarea web (solo ESP32)
+#define MEMORY_STACKS     3
+
+// Últimas muestras y mínimos desde el arranque
+typedef struct {
+    uint32_t heapFree;
+    uint32_t heapFreeMin;                  // 0 = sin muestras
+    uint32_t heapMaxBlock;                 // Bloque libre más grande
+    uint32_t heapMaxBlockMin;
+    uint32_t stackSize[MEMORY_STACKS];     // 0 = la pila no existe
+    uint32_t stackFreeMin[MEMORY_STACKS];  // Bytes que nunca se usaron
+} MemoryStats;
+
+extern MemoryStats memoryStats;
+
+// Muestrear el heap (también al terminar cada pedido HTTP, su punto más alto)
+void sampleHeap();
+
+// Muestrear heap y pilas (tarea del planificador)
+void sampleMemory();
+
+// Nombre de cada pila en el informe y en /metrics
+const char* getStackName(uint8_t stack);
+
+// Porcentaje del heap libre que no está en el bloque contiguo más grande
+uint32_t getHeapFragmentation();
+
+// Resumen para V1: "loop,protocolo,web,heap,heapMin,bloqueMin" en bytes
+void formatMemorySummary(char* out, size_t size);
+
+// Informe completo (JSON de GET /api/memory)
+void printMemoryReport(Print& out);
+
+#endif
@@ -0,0 +1,130 @@
+#include "mensajes.h"
+
+// Cómo usa cada texto el argumento de la respuesta
+#define MSG_ARG_NONE    0         // Texto fijo
+#define MSG_ARG_NUMBER  1         // arg como entero (%d, %02X)
+#define MSG_ARG_CODE    2         // arg como dos caracteres (%c%c)
+#define MSG_ARG_DATA    3         // response.data (%s)
+
+typedef struct {
+  PGM_P text;
+  uint8_t arg;
+} MessageEntry;
+
+static const char msgNone[] PROGMEM = "";
+static const char msgInvalidCommand[] PROGMEM = "Comando inválido";
+static const char msgUnknownFunction[] PROGMEM = "Código de función desconocido";
+static const char msgUnknownSubcode[] PROGMEM = "Subcódigo %c%c desconocido";
+static const char msgNotEnoughData[] PROGMEM = "Datos insuficientes";
+static const char msgNotAllowed[] PROGMEM = "Comando no permitido para este dispositivo";
+static const char msgDeviceIdSet[] PROGMEM = "ID de dispositivo actualizado";
+static const char msgDeviceId[] PROGMEM = "ID de dispositivo: %s";
+static const char msgCompanySet[] PROGMEM = "Nombre de empresa actualizado";
+static const char msgCompany[] PROGMEM = "Nombre de empresa: %s";
+static const char msgTcpModeSet[] PROGMEM = "Modo TCP/IP485 actualizado a %02X";
+static const char msgTcpMode[] PROGMEM = "Modo TCP/IP485: %s";
+static const char msgSerial0Set[] PROGMEM = "Serial Number Byte 0 actualizado a %02X";
+static const char msgScannerEnabled[] PROGMEM = "Scanner habilitado, estado reiniciado";
+static const char msgTurnstilePulse[] PROGMEM = "Molinete activado por pulso";
+static const char msgDdmm1PresentSet[] PROGMEM = "Tiempo presencia DDMM1 configurado a %d";
+static const char msgDdmm2AbsentSet[] PROGMEM = "Tiempo ausencia DDMM2 configurado a %d";
+static const char msgDdmm2PresentSet[] PROGMEM = "Tiempo presencia DDMM2 configurado a %d";
+static const char msgRelayOn[] PROGMEM = "Relé %d activado";
+static const char msgRelayOff[] PROGMEM = "Relé %d desactivado";
+static const char msgLotFull[] PROGMEM = "Playa llena, ingreso inhibido";
+static const char msgLotFree[] PROGMEM = "Playa libre, ingreso habilitado";
+static const char msgBarrierOn[] PROGMEM = "Barrera activada (estado 7)";
+static const char msgReaderReset[] PROGMEM = "Estado lector/scanner reiniciado";
+static const char msgStatusSent[] PROGMEM = "Status enviado: %04X";
+static const char msgTicketLineSent[] PROGMEM = "Línea %d de ticket enviada";
+static const char msgTicketLineSaved[] PROGMEM = "Línea %d de ticket grabada";
+static const char msgTicketIssued[] PROGMEM = "Ticket generado: %s";
+static const char msgVersionSent[] PROGMEM = "Versión enviada";
+static const char msgMemorySent[] PROGMEM = "Memoria enviada";
+static const char msgRestarting[] PROGMEM = "Reiniciando dispositivo...";
+static const char msgStorageSynced[] PROGMEM = "Almacenamiento sincronizado";
+static const char msgStorageSyncFailed[] PROGMEM = "Error al sincronizar almacenamiento";
+static const char msgBarcodeSet[] PROGMEM = "Código de barras configurado: %s";
+static const char msgBarcodeConfig[] PROGMEM = "Configuración de código de barras: %s";
+static const char msgDisplayShown[] PROGMEM = "Configuración mostrada en display";
+static const char msgQueueFull[] PROGMEM = "Cola de comandos llena";
+static const char msgTaskTimeout[] PROGMEM = "Sin respuesta de la tarea de protocolo; el comando no se ejecutó";
+static const char msgConfigUpdated[] PROGMEM = "Configuración actualizada correctamente";
+static const char msgTaskPending[] PROGMEM = "Comando en curso; su resultado no llegó a tiempo";
+
+// En el orden de MessageId
+static const MessageEntry messageCatalog[] PROGMEM = {
+  {msgNone, MSG_ARG_NONE},
+  {msgInvalidCommand, MSG_ARG_NONE},
+  {msgUnknownFunction, MSG_ARG_NONE},
+  {msgUnknownSubcode, MSG_ARG_CODE},
+  {msgNotEnoughData, MSG_ARG_NONE},
+  {msgNotAllowed, MSG_ARG_NONE},
+  {msgDeviceIdSet, MSG_ARG_NONE},
+  {msgDeviceId, MSG_ARG_DATA},
+  {msgCompanySet, MSG_ARG_NONE},
+  {msgCompany, MSG_ARG_DATA},
+  {msgTcpModeSet, MSG_ARG_NUMBER},
+  {msgTcpMode, MSG_ARG_DATA},
+  {msgSerial0Set, MSG_ARG_NUMBER},
+  {msgScannerEnabled, MSG_ARG_NONE},
+  {msgTurnstilePulse, MSG_ARG_NONE},
+  {msgDdmm1PresentSet, MSG_ARG_NUMBER},
+  {msgDdmm2AbsentSet, MSG_ARG_NUMBER},
+  {msgDdmm2PresentSet, MSG_ARG_NUMBER},
+  {msgRelayOn, MSG_ARG_NUMBER},
+  {msgRelayOff, MSG_ARG_NUMBER},
+  {msgLotFull, MSG_ARG_NONE},
+  {msgLotFree, MSG_ARG_NONE},
+  {msgBarrierOn, MSG_ARG_NONE},
+  {msgReaderReset, MSG_ARG_NONE},
+  {msgStatusSent, MSG_ARG_NUMBER},
+  {msgTicketLineSent, MSG_ARG_NUMBER},
+  {msgTicketLineSaved, MSG_ARG_NUMBER},
+  {msgTicketIssued, MSG_ARG_DATA},
+  {msgVersionSent, MSG_ARG_NONE},
+  {msgMemorySent, MSG_ARG_NONE},
+  {msgRestarting, MSG_ARG_NONE},
+  {msgStorageSynced, MSG_ARG_NONE},
+  {msgStorageSyncFailed, MSG_ARG_NONE},
+  {msgBarcodeSet, MSG_ARG_DATA},
+  {msgBarcodeConfig, MSG_ARG_DATA},
+  {msgDisplayShown, MSG_ARG_NONE},
+  {msgQueueFull, MSG_ARG_NONE},
+  {msgTaskTimeout, MSG_ARG_NONE},
+  {msgConfigUpdated, MSG_ARG_NONE},
+  {msgTaskPending, MSG_ARG_NONE},
+};
+
+static_assert(sizeof(messageCatalog) / sizeof(messageCatalog[0]) == MESSAGE_COUNT,
+              "messageCatalog y MessageId deben tener los mismos mensajes");
+
+size_t formatMessage(const CommandResponse& response, char* out, size_t size) {
+  if (size == 0) return 0;
+  
+  out[0] = '\0';
+  if (response.message >= MESSAGE_COUNT) return 0;
+  
+  MessageEntry entry;
+  memcpy_P(&entry, &messageCatalog[response.message], sizeof(entry));
+  
+  int n = 0;
+  switch (entry.arg) {
+    case MSG_ARG_NUMBER:
+      n = snprintf_P(out, size, entry.text, (int)response.arg);
+      break;
+    case MSG_ARG_CODE:
+      n = snprintf_P(out, size, entry.text, (char)(response.arg >> 8), (char)(response.arg & 0xFF));
+      break;
+    case MSG_ARG_DATA:
+      n = snprintf_P(out, size, entry.text, response.data);
+      break;
+    default:
+      strncpy_P(out, entry.text, size - 1);
+      out[size - 1] = '\0';
+      return strlen(out);
+  }
+  
+  if (n < 0) return 0;
+  return min((size_t)n, size - 1);
+}
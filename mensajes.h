@@ -0,0 +1,73 @@
+#ifndef MENSAJES_H
+#define MENSAJES_H
+
+#include "estructuras.h"
+#include <Arduino.h>
+
+// Catálogo de mensajes de los comandos
+// Los procesadores del protocolo no arman texto: dejan en CommandResponse el
+// número de mensaje y un argumento. Los textos viven en flash (PROGMEM) y solo
+// se formatean cuando alguien los muestra (API REST, páginas web, log).
+
+#define MESSAGE_TEXT_SIZE 64      // Mayor mensaje formateado, con el '\0'
+
+// Números de mensaje; el orden coincide con la tabla de mensajes.cpp
+typedef enum {
+  MSG_NONE = 0,
+  MSG_INVALID_COMMAND,
+  MSG_UNKNOWN_FUNCTION,
+  MSG_UNKNOWN_SUBCODE,            // arg: código y subcódigo (messageCode)
+  MSG_NOT_ENOUGH_DATA,
+  MSG_NOT_ALLOWED,
+  MSG_DEVICE_ID_SET,
+  MSG_DEVICE_ID,                  // data
+  MSG_COMPANY_SET,
+  MSG_COMPANY,                    // data
+  MSG_TCP_MODE_SET,               // arg: modo
+  MSG_TCP_MODE,                   // data
+  MSG_SERIAL0_SET,                // arg: byte 0 del número de serie
+  MSG_SCANNER_ENABLED,
+  MSG_TURNSTILE_PULSE,
+  MSG_DDMM1_PRESENT_SET,          // arg: tiempo
+  MSG_DDMM2_ABSENT_SET,           // arg: tiempo
+  MSG_DDMM2_PRESENT_SET,          // arg: tiempo
+  MSG_RELAY_ON,                   // arg: relé
+  MSG_RELAY_OFF,                  // arg: relé
+  MSG_LOT_FULL,
+  MSG_LOT_FREE,
+  MSG_BARRIER_ON,
+  MSG_READER_RESET,
+  MSG_STATUS_SENT,                // arg: bits de status
+  MSG_TICKET_LINE_SENT,           // arg: línea
+  MSG_TICKET_LINE_SAVED,          // arg: línea
+  MSG_TICKET_ISSUED,              // data
+  MSG_VERSION_SENT,
+  MSG_MEMORY_SENT,
+  MSG_RESTARTING,
+  MSG_STORAGE_SYNCED,
+  MSG_STORAGE_SYNC_FAILED,
+  MSG_BARCODE_SET,                // data
+  MSG_BARCODE_CONFIG,             // data
+  MSG_DISPLAY_SHOWN,
+  MSG_QUEUE_FULL,
+  MSG_TASK_TIMEOUT,
+  MSG_CONFIG_UPDATED,             // arg: 1 si hace falta reiniciar
+  MSG_TASK_PENDING,
+  MESSAGE_COUNT
+} MessageId;
+
+// Dejar el mensaje en la respuesta (sin formatear)
+inline void setMessage(CommandResponse& response, uint8_t message, uint16_t arg = 0) {
+  response.message = message;
+  response.arg = arg;
+}
+
+// Argumento de MSG_UNKNOWN_SUBCODE: código de función y subcódigo
+inline uint16_t messageCode(char functionCode, char subCode) {
+  return ((uint8_t)functionCode << 8) | (uint8_t)subCode;
+}
+
+// Texto del mensaje de una respuesta ("" si no tiene)
+size_t formatMessage(const CommandResponse& response, char* out, size_t size);
+
+#endif
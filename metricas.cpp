@@ -0,0 +1,223 @@
+#include "metricas.h"
+#include "perfil.h"
+#include "variables.h"
+#include "servidor.h"
+#include "transporte_tcp.h"
+#include "pasarela.h"
+#include "arena.h"
+#include "memoria.h"
+
+// Límites superiores de los buckets del histograma de loop(), en microsegundos
+static const uint32_t loopBucketLimits[LOOP_BUCKETS] = {100, 500, 1000, 5000, 20000, 100000};
+
+static const char* dropReasons[DROP_REASONS] = {
+  "incomplete", "overflow", "invalid", "other_device", "unknown_function"
+};
+
+// Solo la tarea de protocolo escribe estos campos; /metrics los lee desde la
+// web, en el otro núcleo en ESP32. El total de 64 bits va con operaciones
+// atómicas para que esa lectura no quede partida entre dos escrituras
+void recordLoopTime(uint32_t durationUs) {
+  metrics.loopCount++;
+  #ifdef ESP32
+    __atomic_fetch_add(&metrics.loopTotalUs, (uint64_t)durationUs, __ATOMIC_RELAXED);
+  #else
+    metrics.loopTotalUs += durationUs;
+  #endif
+  if (durationUs > metrics.loopMaxUs) metrics.loopMaxUs = durationUs;
+
+  for (int i = 0; i < LOOP_BUCKETS; i++) {
+    if (durationUs <= loopBucketLimits[i]) {
+      metrics.loopBuckets[i]++;
+      break;
+    }
+  }
+}
+
+// El resto arma /metrics: solo en perfiles con servidor HTTP (perfil.h)
+#if PROFILE_HTTP
+
+// Escribir una línea "nombre{etiqueta="valor"} contador"
+static void printSample(Print& out, const char* name, const char* label, const char* labelValue, uint32_t value) {
+  out.print(name);
+  if (label != NULL) {
+    out.print("{");
+    out.print(label);
+    out.print("=\"");
+    out.print(labelValue);
+    out.print("\"}");
+  }
+  out.print(" ");
+  out.print((unsigned long)value);
+  out.print("\n");
+}
+
+static void printType(Print& out, const char* name, const char* type) {
+  out.print("# TYPE ");
+  out.print(name);
+  out.print(" ");
+  out.print(type);
+  out.print("\n");
+}
+
+static const char* methodName(HTTPMethod method) {
+  switch (method) {
+    case HTTP_GET:    return "GET";
+    case HTTP_POST:   return "POST";
+    case HTTP_PUT:    return "PUT";
+    case HTTP_PATCH:  return "PATCH";
+    case HTTP_DELETE: return "DELETE";
+    default:          return "ANY";
+  }
+}
+
+// Segundos con resolución de microsegundos
+static uint64_t readLoopTotalUs() {
+  #ifdef ESP32
+    return __atomic_load_n(&metrics.loopTotalUs, __ATOMIC_RELAXED);
+  #else
+    return metrics.loopTotalUs;
+  #endif
+}
+
+static void printSeconds(Print& out, uint64_t us) {
+  char value[24];
+  snprintf(value, sizeof(value), "%lu.%06lu", (unsigned long)(us / 1000000), (unsigned long)(us % 1000000));
+  out.print(value);
+}
+
+void printMetrics(Print& out) {
+  char label[8];
+
+  // Perfil de compilación (perfil.h)
+  printType(out, "oemproxy_build_info", "gauge");
+  printSample(out, "oemproxy_build_info", "profile", buildProfile.name, 1);
+
+  // Tramas del protocolo
+  printType(out, "oemproxy_frames_received_total", "counter");
+  printSample(out, "oemproxy_frames_received_total", NULL, NULL, metrics.framesReceived);
+  printType(out, "oemproxy_frames_processed_total", "counter");
+  printSample(out, "oemproxy_frames_processed_total", NULL, NULL, metrics.framesProcessed);
+  printType(out, "oemproxy_frames_dropped_total", "counter");
+  for (int i = 0; i < DROP_REASONS; i++) {
+    printSample(out, "oemproxy_frames_dropped_total", "reason", dropReasons[i], metrics.framesDropped[i]);
+  }
+
+  printType(out, "oemproxy_ack_sent_total", "counter");
+  printSample(out, "oemproxy_ack_sent_total", NULL, NULL, metrics.ackSent);
+  printType(out, "oemproxy_nak_sent_total", "counter");
+  printSample(out, "oemproxy_nak_sent_total", NULL, NULL, metrics.nakSent);
+
+  // Solo los códigos de función que se usaron
+  printType(out, "oemproxy_commands_total", "counter");
+  for (int i = 0; i < 26; i++) {
+    if (metrics.commands[i] == 0) continue;
+    label[0] = 'A' + i;
+    label[1] = '\0';
+    printSample(out, "oemproxy_commands_total", "function", label, metrics.commands[i]);
+  }
+
+  printType(out, "oemproxy_relay_actuations_total", "counter");
+  for (int i = 0; i < RELAY_COUNT; i++) {
+    label[0] = '1' + i;
+    label[1] = '\0';
+    printSample(out, "oemproxy_relay_actuations_total", "relay", label, metrics.relayActuations[i]);
+  }
+
+  printType(out, "oemproxy_storage_commits_total", "counter");
+  printSample(out, "oemproxy_storage_commits_total", NULL, NULL, metrics.storageCommits);
+
+  // Duración de loop(): histograma acumulado y máximo desde el arranque
+  printType(out, "oemproxy_loop_duration_seconds", "histogram");
+  uint32_t cumulative = 0;
+  for (int i = 0; i < LOOP_BUCKETS; i++) {
+    cumulative += metrics.loopBuckets[i];
+    out.print("oemproxy_loop_duration_seconds_bucket{le=\"");
+    printSeconds(out, loopBucketLimits[i]);
+    out.print("\"} ");
+    out.print((unsigned long)cumulative);
+    out.print("\n");
+  }
+  printSample(out, "oemproxy_loop_duration_seconds_bucket", "le", "+Inf", metrics.loopCount);
+  out.print("oemproxy_loop_duration_seconds_sum ");
+  printSeconds(out, readLoopTotalUs());
+  out.print("\n");
+  printSample(out, "oemproxy_loop_duration_seconds_count", NULL, NULL, metrics.loopCount);
+
+  printType(out, "oemproxy_loop_duration_max_seconds", "gauge");
+  out.print("oemproxy_loop_duration_max_seconds ");
+  printSeconds(out, metrics.loopMaxUs);
+  out.print("\n");
+
+  // Memoria
+  sampleHeap();
+  printType(out, "oemproxy_heap_free_bytes", "gauge");
+  printSample(out, "oemproxy_heap_free_bytes", NULL, NULL, memoryStats.heapFree);
+  printType(out, "oemproxy_heap_max_block_bytes", "gauge");
+  printSample(out, "oemproxy_heap_max_block_bytes", NULL, NULL, memoryStats.heapMaxBlock);
+  printType(out, "oemproxy_heap_free_min_bytes", "gauge");
+  printSample(out, "oemproxy_heap_free_min_bytes", NULL, NULL, memoryStats.heapFreeMin);
+  printType(out, "oemproxy_heap_max_block_min_bytes", "gauge");
+  printSample(out, "oemproxy_heap_max_block_min_bytes", NULL, NULL, memoryStats.heapMaxBlockMin);
+  printType(out, "oemproxy_heap_fragmentation_percent", "gauge");
+  printSample(out, "oemproxy_heap_fragmentation_percent", NULL, NULL, getHeapFragmentation());
+
+  // Pilas que existen en esta placa (memoria.h)
+  printType(out, "oemproxy_stack_free_min_bytes", "gauge");
+  for (int i = 0; i < MEMORY_STACKS; i++) {
+    if (memoryStats.stackSize[i] == 0) continue;
+    printSample(out, "oemproxy_stack_free_min_bytes", "stack", getStackName(i), memoryStats.stackFreeMin[i]);
+  }
+
+  // Arena de los pedidos HTTP
+  printType(out, "oemproxy_arena_peak_bytes", "gauge");
+  printSample(out, "oemproxy_arena_peak_bytes", NULL, NULL, requestArena.getPeak());
+  printType(out, "oemproxy_arena_overflows_total", "counter");
+  printSample(out, "oemproxy_arena_overflows_total", NULL, NULL, requestArena.getOverflows());
+
+  // Pedidos HTTP por ruta
+  printType(out, "oemproxy_http_requests_total", "counter");
+  for (uint8_t i = 0; i < server.getRouteCount(); i++) {
+    out.print("oemproxy_http_requests_total{path=\"");
+    out.print(server.getRouteUri(i));
+    out.print("\",method=\"");
+    out.print(methodName(server.getRouteMethod(i)));
+    out.print("\"} ");
+    out.print((unsigned long)server.getRouteRequests(i));
+    out.print("\n");
+  }
+  printSample(out, "oemproxy_http_requests_total", "path", "other", server.getNotFoundRequests());
+
+  // Control de admisión (429 y pedidos postergados)
+  uint32_t endpointRejected = 0;
+  for (uint8_t i = 0; i < server.getRouteCount(); i++) {
+    endpointRejected += server.getRouteRejected(i);
+  }
+  printType(out, "oemproxy_http_rejected_total", "counter");
+  printSample(out, "oemproxy_http_rejected_total", "reason", "endpoint", endpointRejected);
+  printSample(out, "oemproxy_http_rejected_total", "reason", "client", server.getClientRejected());
+  printType(out, "oemproxy_http_deferred_total", "counter");
+  printSample(out, "oemproxy_http_deferred_total", NULL, NULL, server.getDeferred());
+
+  // Protocolo por TCP
+  #if PROFILE_TCP
+    printType(out, "oemproxy_tcp_connections_total", "counter");
+    printSample(out, "oemproxy_tcp_connections_total", NULL, NULL, metrics.tcpAccepted);
+    printType(out, "oemproxy_tcp_clients", "gauge");
+    printSample(out, "oemproxy_tcp_clients", NULL, NULL, getProtocolTcpClients());
+  #endif
+
+  // Pasarela TCP → RS485
+  #if PROFILE_GATEWAY
+    printType(out, "oemproxy_gateway_requests_total", "counter");
+    printSample(out, "oemproxy_gateway_requests_total", NULL, NULL, metrics.gatewayRequests);
+    printType(out, "oemproxy_gateway_coalesced_total", "counter");
+    printSample(out, "oemproxy_gateway_coalesced_total", NULL, NULL, metrics.gatewayCoalesced);
+    printType(out, "oemproxy_gateway_timeouts_total", "counter");
+    printSample(out, "oemproxy_gateway_timeouts_total", NULL, NULL, metrics.gatewayTimeouts);
+    printType(out, "oemproxy_gateway_pending", "gauge");
+    printSample(out, "oemproxy_gateway_pending", NULL, NULL, getGatewayPending());
+  #endif
+}
+
+#endif
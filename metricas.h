@@ -0,0 +1,28 @@
+#ifndef METRICAS_H
+#define METRICAS_H
+
+#include <Arduino.h>
+
+// Métricas en formato de texto de Prometheus
+// Los contadores viven en la variable global metrics (variables.h) y se
+// incrementan directamente donde ocurre cada evento; aquí solo se miden las
+// vueltas de loop() y se arma la salida de /metrics
+
+// Sumar uno a un contador que incrementan dos tareas. En ESP32 el armado de
+// tramas corre en la tarea de protocolo (bus) y en la web (TCP), en núcleos
+// distintos, y un ++ puede perder cuentas. ESP8266 tiene una sola tarea
+inline void countMetric(uint32_t& counter) {
+  #ifdef ESP32
+    __atomic_fetch_add(&counter, 1, __ATOMIC_RELAXED);
+  #else
+    counter++;
+  #endif
+}
+
+// Registrar la duración de una vuelta de loop()
+void recordLoopTime(uint32_t durationUs);
+
+// Escribir todas las métricas
+void printMetrics(Print& out);
+
+#endif
@@ -0,0 +1,219 @@
+#include "pasarela.h"
+#include "perfil.h"
+#include "protocolo.h"
+#include "utilidades.h"
+#include "variables.h"
+
+// Solo en perfiles con pasarela (perfil.h)
+#if PROFILE_GATEWAY
+
+// Transacción del bus y las conexiones que esperan su respuesta
+typedef struct {
+  char frame[64];
+  uint8_t waiters;
+  uint8_t slot[GATEWAY_MAX_PENDING];
+  uint16_t tag[GATEWAY_MAX_PENDING];
+} GatewayTransaction;
+
+// Tiempos de respuesta de un equipo del bus
+typedef struct {
+  bool used;
+  char id[2];
+  uint16_t worstRttMs;         // Peor respuesta reciente (decae de a poco)
+  uint8_t misses;              // Timeouts seguidos
+  unsigned long lastUsed;
+} GatewayDevice;
+
+// Web → protocolo y protocolo → web
+static SpscRing<GatewayRequest, GATEWAY_QUEUE_SIZE> requestQueue;
+static SpscRing<GatewayReply, GATEWAY_QUEUE_SIZE> replyQueue;
+
+// Solo la tarea de protocolo usa lo que sigue
+static GatewayTransaction pending[GATEWAY_MAX_PENDING];   // En orden de llegada
+static uint8_t pendingCount = 0;
+static bool inFlight = false;                             // pending[0] ya salió al bus
+static unsigned long sentAt = 0;
+static GatewayDevice devices[GATEWAY_MAX_DEVICES];
+static GatewayDevice* inFlightDevice = NULL;
+
+// Lecturas sin efectos que pueden compartir una misma transacción
+static const char coalescedReads[][3] = {
+  "A1", "A5", "A7", "S0", "T0", "T1", "T2", "T3", "V0", "Z1"
+};
+
+static bool isCoalescible(const char* frame) {
+  if (strlen(frame) != 6) return false; // Solo consultas sin datos
+  
+  for (uint8_t i = 0; i < sizeof(coalescedReads) / sizeof(coalescedReads[0]); i++) {
+    if (frame[3] == coalescedReads[i][0] && frame[4] == coalescedReads[i][1]) return true;
+  }
+  return false;
+}
+
+bool isGatewayFrame(const char* frame) {
+  if (config.modo_tcpip485 != TCPIP_MODE_GATEWAY) return false;
+  if (strlen(frame) < 6) return false;
+  
+  return frame[1] != config.deviceIdStr[0] || frame[2] != config.deviceIdStr[1];
+}
+
+bool gatewaySubmit(uint8_t slot, uint16_t tag, const char* frame) {
+  GatewayRequest request;
+  request.slot = slot;
+  request.tag = tag;
+  safeStrCopy(request.frame, frame, sizeof(request.frame));
+  return requestQueue.push(request);
+}
+
+bool gatewayPollReply(GatewayReply& reply) {
+  return replyQueue.pop(reply);
+}
+
+static void sendReply(uint8_t slot, uint16_t tag, const char* frame) {
+  GatewayReply reply;
+  reply.slot = slot;
+  reply.tag = tag;
+  safeStrCopy(reply.frame, frame != NULL ? frame : "", sizeof(reply.frame));
+  
+  // Cola llena: la conexión deja de esperar cuando vence su inactividad
+  replyQueue.push(reply);
+}
+
+// Equipo de la trama; si no está, ocupa un lugar libre o el menos usado
+static GatewayDevice* findDevice(const char* frame) {
+  GatewayDevice* victim = &devices[0];
+  
+  for (uint8_t i = 0; i < GATEWAY_MAX_DEVICES; i++) {
+    GatewayDevice& device = devices[i];
+    if (device.used && device.id[0] == frame[1] && device.id[1] == frame[2]) {
+      device.lastUsed = millis();
+      return &device;
+    }
+    
+    if (!victim->used) continue;
+    if (!device.used || device.lastUsed < victim->lastUsed) victim = &device;
+  }
+  
+  victim->used = true;
+  victim->id[0] = frame[1];
+  victim->id[1] = frame[2];
+  victim->worstRttMs = 0;
+  victim->misses = 0;
+  victim->lastUsed = millis();
+  return victim;
+}
+
+// Un equipo ausente solo recibe un sondeo corto para no frenar la cola;
+// uno lento gana margen según sus respuestas anteriores
+static unsigned long deviceTimeout(const GatewayDevice* device) {
+  if (device->misses >= GATEWAY_OFFLINE_AFTER) return GATEWAY_TIMEOUT_MIN_MS;
+  
+  return constrain(2UL * device->worstRttMs, GATEWAY_TIMEOUT_MS, GATEWAY_TIMEOUT_MAX_MS);
+}
+
+// Sumar la trama a la transacción igual pendiente o crear una nueva
+static bool addRequest(const GatewayRequest& request) {
+  GatewayTransaction* transaction = NULL;
+  
+  if (isCoalescible(request.frame)) {
+    for (uint8_t i = 0; i < pendingCount; i++) {
+      if (pending[i].waiters < GATEWAY_MAX_PENDING && strcmp(pending[i].frame, request.frame) == 0) {
+        transaction = &pending[i];
+        metrics.gatewayCoalesced++;
+        break;
+      }
+    }
+  }
+  
+  if (transaction == NULL) {
+    if (pendingCount >= GATEWAY_MAX_PENDING) return false;
+    
+    transaction = &pending[pendingCount++];
+    strcpy(transaction->frame, request.frame);
+    transaction->waiters = 0;
+  }
+  
+  transaction->slot[transaction->waiters] = request.slot;
+  transaction->tag[transaction->waiters] = request.tag;
+  transaction->waiters++;
+  return true;
+}
+
+static void acceptRequests() {
+  GatewayRequest request;
+  while (requestQueue.pop(request)) {
+    metrics.gatewayRequests++;
+    
+    // Sin lugar: la conexión recibe una respuesta vacía, como si no contestara
+    if (!addRequest(request)) sendReply(request.slot, request.tag, NULL);
+  }
+}
+
+static void startTransaction() {
+  if (inFlight || pendingCount == 0) return;
+  
+  inFlightDevice = findDevice(pending[0].frame);
+  sendRawCommand(pending[0].frame);
+  sentAt = millis();
+  inFlight = true;
+  
+  // Las respuestas con datos terminan en SIB, no en ETX
+  setBusFrameEndOnSib(true);
+}
+
+// Entregar la respuesta (NULL si no hubo) a todas las conexiones en espera
+static void finishTransaction(const char* reply) {
+  GatewayTransaction& transaction = pending[0];
+  for (uint8_t i = 0; i < transaction.waiters; i++) {
+    sendReply(transaction.slot[i], transaction.tag[i], reply);
+  }
+  
+  pendingCount--;
+  memmove(&pending[0], &pending[1], pendingCount * sizeof(GatewayTransaction));
+  inFlight = false;
+  setBusFrameEndOnSib(false);
+}
+
+void gatewayLoop() {
+  acceptRequests();
+  
+  if (inFlight) {
+    if (millis() - sentAt < deviceTimeout(inFlightDevice)) return;
+    
+    if (inFlightDevice->misses < 255) inFlightDevice->misses++;
+    metrics.gatewayTimeouts++;
+    finishTransaction(NULL);
+  }
+  
+  startTransaction();
+}
+
+bool gatewayTakeFrame(const char* frame) {
+  if (!inFlight) return false;
+  
+  // Mismo equipo y misma función, o su ACK/NAK
+  const char* sent = pending[0].frame;
+  if (frame[1] != sent[1] || frame[2] != sent[2]) return false;
+  if (frame[3] != sent[3] && frame[3] != ACK && frame[3] != NAK) return false;
+  
+  unsigned long rtt = millis() - sentAt;
+  uint16_t decayed = inFlightDevice->worstRttMs - inFlightDevice->worstRttMs / 16;
+  inFlightDevice->worstRttMs = max((uint16_t)rtt, decayed);
+  inFlightDevice->misses = 0;
+  
+  finishTransaction(frame);
+  
+  // El bus quedó libre: no esperar a la próxima pasada
+  startTransaction();
+  return true;
+}
+
+uint8_t getGatewayPending() {
+  return pendingCount;
+}
+
+size_t getGatewayRam() {
+  return sizeof(requestQueue) + sizeof(replyQueue) + sizeof(pending) + sizeof(devices);
+}
+
+#endif
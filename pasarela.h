@@ -0,0 +1,58 @@
+#ifndef PASARELA_H
+#define PASARELA_H
+
+#include "estructuras.h"
+#include "tareas.h"
+#include <Arduino.h>
+
+// Pasarela TCP → RS485
+// Con modo_tcpip485 = TCPIP_MODE_GATEWAY las tramas que llegan por TCP para
+// otros IDs se encolan y salen al bus de a una (half-duplex). La respuesta se
+// reconoce por ID de equipo y código de función y vuelve a la conexión que la
+// pidió. Las lecturas idénticas pendientes (p. ej. dos clientes con S0 al
+// mismo equipo) comparten una sola transacción en el bus.
+// Las tramas entran por la tarea web (gatewaySubmit) y el bus lo atiende la
+// tarea de protocolo (gatewayLoop); entre ambas solo hay colas SPSC.
+
+#define GATEWAY_MAX_PENDING       4       // Transacciones en espera (una por conexión)
+#define GATEWAY_QUEUE_SIZE        8       // Elementos por cola (uno queda libre)
+#define GATEWAY_MAX_DEVICES       16      // Equipos con tiempos propios
+#define GATEWAY_TIMEOUT_MS        250     // Espera por una respuesta
+#define GATEWAY_TIMEOUT_MIN_MS    30      // Sondeo de un equipo ausente
+#define GATEWAY_TIMEOUT_MAX_MS    1000    // Tope para equipos lentos
+#define GATEWAY_OFFLINE_AFTER     3       // Timeouts seguidos hasta darlo por ausente
+
+// Trama de un cliente TCP para otro equipo del bus
+typedef struct {
+    uint8_t slot;                // Conexión que la envió
+    uint16_t tag;                // Secuencia de la conexión (descarta respuestas viejas)
+    char frame[64];              // Trama completa STX..ETX
+} GatewayRequest;
+
+// Respuesta del bus para una conexión; frame vacío si el equipo no respondió
+typedef struct {
+    uint8_t slot;
+    uint16_t tag;
+    char frame[TASK_REPLY_SIZE];
+} GatewayReply;
+
+// Trama TCP que debe ir al bus (modo pasarela y ID ajeno)
+bool isGatewayFrame(const char* frame);
+
+// Lado web: encolar una trama y recoger respuestas
+bool gatewaySubmit(uint8_t slot, uint16_t tag, const char* frame);
+bool gatewayPollReply(GatewayReply& reply);
+
+// Lado protocolo: avanzar la transacción en curso y arrancar la siguiente
+void gatewayLoop();
+
+// Trama completa recibida del bus; true si era la respuesta esperada
+bool gatewayTakeFrame(const char* frame);
+
+// Transacciones en espera o en curso
+uint8_t getGatewayPending();
+
+// RAM estática de colas, transacciones y equipos (memoria.h)
+size_t getGatewayRam();
+
+#endif
@@ -0,0 +1,89 @@
+#ifndef PERFIL_H
+#define PERFIL_H
+
+#include <stdint.h>
+
+// Perfiles de compilación
+// Cada perfil fija al compilar cuántos relés se manejan, qué familias de
+// comandos atiende el despacho y qué partes de red entran en la imagen. Se
+// elige con -DBUILD_PROFILE=BUILD_PROFILE_... (build_flags de PlatformIO o
+// --build-property de arduino-cli); sin definirlo se compila todo.
+// Las partes de red excluyen archivos enteros, por eso son macros; el resto
+// se lee de buildProfile (constexpr) y el compilador descarta las ramas que
+// el perfil no usa.
+
+#define BUILD_PROFILE_FULL     0   // Bus, páginas web, API REST, TCP y pasarela
+#define BUILD_PROFILE_LANE     1   // Controlador de carril: solo RS485, sin red
+#define BUILD_PROFILE_GATEWAY  2   // Pasarela TCP → RS485 con API REST, sin páginas
+
+#ifndef BUILD_PROFILE
+  #define BUILD_PROFILE BUILD_PROFILE_FULL
+#endif
+
+#if BUILD_PROFILE == BUILD_PROFILE_FULL
+  #define PROFILE_NAME      "full"
+  #define PROFILE_RELAYS    5
+  #define PROFILE_FAMILIES  "ABCDEGHJKMOPRSTVXZ"
+  #define PROFILE_WEB_UI    1
+  #define PROFILE_REST_API  1
+  #define PROFILE_TCP       1
+  #define PROFILE_GATEWAY   1
+  #define PROFILE_DEBUG_LOG 1
+#elif BUILD_PROFILE == BUILD_PROFILE_LANE
+  #define PROFILE_NAME      "lane"
+  #define PROFILE_RELAYS    2       // Barrera (relé 1) y playa llena (relé 2)
+  #define PROFILE_FAMILIES  "ABCDEGHJKMOPRSTVXZ"
+  #define PROFILE_WEB_UI    0
+  #define PROFILE_REST_API  0
+  #define PROFILE_TCP       0
+  #define PROFILE_GATEWAY   0
+  #define PROFILE_DEBUG_LOG 0
+#elif BUILD_PROFILE == BUILD_PROFILE_GATEWAY
+  #define PROFILE_NAME      "gateway"
+  #define PROFILE_RELAYS    1       // Sin relés propios (no atiende C/R/S); no hay arreglos vacíos
+  #define PROFILE_FAMILIES  "AVX"   // Configuración, versión/memoria y reinicio
+  #define PROFILE_WEB_UI    0
+  #define PROFILE_REST_API  1
+  #define PROFILE_TCP       1
+  #define PROFILE_GATEWAY   1
+  #define PROFILE_DEBUG_LOG 0
+#else
+  #error "BUILD_PROFILE desconocido"
+#endif
+
+// Servidor HTTP (servidor, arena, /metrics): lo necesitan las páginas o la API
+#define PROFILE_HTTP (PROFILE_WEB_UI || PROFILE_REST_API)
+
+#if PROFILE_GATEWAY && !PROFILE_TCP
+  #error "La pasarela necesita el protocolo por TCP"
+#endif
+
+// Vista tipada del perfil elegido
+struct BuildProfile {
+  const char* name;
+  uint8_t relays;
+  const char* families;         // Códigos de función del despacho
+  bool webUi;
+  bool restApi;
+  bool tcp;
+  bool gateway;
+  bool debugLog;
+};
+
+constexpr BuildProfile buildProfile = {
+  PROFILE_NAME, PROFILE_RELAYS, PROFILE_FAMILIES,
+  PROFILE_WEB_UI != 0, PROFILE_REST_API != 0, PROFILE_TCP != 0,
+  PROFILE_GATEWAY != 0, PROFILE_DEBUG_LOG != 0
+};
+
+// Relés manejados (tamaño de relays[] y de los contadores por relé)
+constexpr uint8_t RELAY_COUNT = buildProfile.relays;
+
+static_assert(RELAY_COUNT >= 1 && RELAY_COUNT <= 5, "El perfil debe manejar entre 1 y 5 relés");
+
+// La familia de comandos entra en el despacho de este perfil
+constexpr bool hasCommandFamily(char functionCode, const char* families = PROFILE_FAMILIES) {
+  return *families != '\0' && (*families == functionCode || hasCommandFamily(functionCode, families + 1));
+}
+
+#endif
@@ -0,0 +1,66 @@
+#include "planificador.h"
+
+uint32_t runTasks(SchedulerTask* tasks, uint8_t count) {
+  uint32_t passStart = micros();
+  
+  for (uint8_t i = 0; i < count; i++) {
+    SchedulerTask& task = tasks[i];
+    uint32_t start = micros();
+    
+    if (task.periodUs > 0) {
+      uint32_t elapsed = start - task.lastRunUs;
+      if (elapsed < task.periodUs) continue;
+      
+      // Demora: cuánto después del vencimiento arrancó (la primera no cuenta)
+      uint32_t late = elapsed - task.periodUs;
+      if (task.runs > 0 && late > task.maxLateUs) task.maxLateUs = late;
+      
+      // Mantener la cadencia; si se perdió más de un período, resincronizar
+      task.lastRunUs = late < task.periodUs ? task.lastRunUs + task.periodUs : start;
+    }
+    
+    task.run();
+    
+    uint32_t duration = micros() - start;
+    task.runs++;
+    task.lastUs = duration;
+    task.totalUs += duration;
+    if (duration > task.maxUs) task.maxUs = duration;
+    if (duration > task.budgetUs) task.overruns++;
+  }
+  
+  return micros() - passStart;
+}
+
+// Los contadores los escribe otra tarea: los valores pueden quedar
+// desfasados entre sí, lo que no importa para diagnóstico
+void printTaskStats(Print& out, const SchedulerTask* tasks, uint8_t count) {
+  out.print("[");
+  
+  for (uint8_t i = 0; i < count; i++) {
+    const SchedulerTask& task = tasks[i];
+    if (i > 0) out.print(",");
+    
+    out.print("{\"name\":\"");
+    out.print(task.name);
+    out.print("\",\"periodUs\":");
+    out.print((unsigned long)task.periodUs);
+    out.print(",\"budgetUs\":");
+    out.print((unsigned long)task.budgetUs);
+    out.print(",\"runs\":");
+    out.print((unsigned long)task.runs);
+    out.print(",\"overruns\":");
+    out.print((unsigned long)task.overruns);
+    out.print(",\"lastUs\":");
+    out.print((unsigned long)task.lastUs);
+    out.print(",\"avgUs\":");
+    out.print((unsigned long)(task.runs > 0 ? task.totalUs / task.runs : 0));
+    out.print(",\"maxUs\":");
+    out.print((unsigned long)task.maxUs);
+    out.print(",\"maxLateUs\":");
+    out.print((unsigned long)task.maxLateUs);
+    out.print("}");
+  }
+  
+  out.print("]");
+}
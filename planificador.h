@@ -0,0 +1,23 @@
+#ifndef PLANIFICADOR_H
+#define PLANIFICADOR_H
+
+#include "estructuras.h"
+#include <Arduino.h>
+
+// Planificador cooperativo
+// Cada subsistema es una SchedulerTask con período y presupuesto de tiempo.
+// runTasks() hace una pasada por la tabla, ejecuta las tareas vencidas y
+// registra duración, peor caso, demora y ejecuciones fuera de presupuesto.
+// Las tablas se declaran estáticas, p. ej.:
+//   static SchedulerTask tasks[] = {
+//     SCHEDULER_TASK("relays", updateRelays, 100000, 200),
+//   };
+#define SCHEDULER_TASK(name, run, periodUs, budgetUs) {name, run, periodUs, budgetUs, 0, 0, 0, 0, 0, 0, 0}
+
+// Ejecutar las tareas vencidas; devuelve la duración de la pasada en µs
+uint32_t runTasks(SchedulerTask* tasks, uint8_t count);
+
+// Volcar las estadísticas de una tabla como arreglo JSON
+void printTaskStats(Print& out, const SchedulerTask* tasks, uint8_t count);
+
+#endif
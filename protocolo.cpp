@@ -1,952 +1,1286 @@
-#include "protocolo.h"
-#include "utilidades.h"
-#include "almacenamiento.h"
-#include <Arduino.h>
-
-#ifdef ESP8266
-  #include <SoftwareSerial.h>
-  extern SoftwareSerial rs485Serial;
-#elif defined(ESP32)
-  #include <HardwareSerial.h>
-  extern HardwareSerial rs485Serial;
-#endif
-
-// Implementación de funciones de parsing de comandos
-bool parseCommand(const char* cmd, char* functionCode, char* subCode, char* data, int* dataLen) {
-  // Verificar longitud mínima (STX + ID[2] + FUNC + SUBFUNC + ETX = 6)
-  int len = strlen(cmd);
-  if (len < 6) return false;
-  
-  // Verificar STX y ETX
-  if (cmd[0] != STX || cmd[len-1] != ETX) return false;
-  
-  // Extraer ID del dispositivo (2 caracteres)
-  char deviceIdStr[3] = {cmd[1], cmd[2], '\0'};
-  
-  // Verificar si el comando es para este dispositivo
-  if (strcmp(deviceIdStr, config.deviceIdStr) != 0) return false;
-  
-  // Extraer código de función y subfunción
-  *functionCode = cmd[3];
-  *subCode = cmd[4];
-  
-  // Extraer datos si hay
-  *dataLen = len - 6; // STX + ID[2] + FUNC + SUBFUNC + ETX = 6
-  if (*dataLen > 0) {
-    memcpy(data, &cmd[5], *dataLen);
-    data[*dataLen] = '\0';
-  } else {
-    data[0] = '\0';
-  }
-  
-  return true;
-}
-
-bool validateCommand(const char* cmd, int len) {
-  // Verificar longitud mínima
-  if (len < 6) return false;
-  
-  // Verificar STX y ETX
-  if (cmd[0] != STX || cmd[len-1] != ETX) return false;
-  
-  // Aquí se podría agregar verificación de checksum si el protocolo lo usa
-  
-  return true;
-}
-
-// Implementación de funciones para procesar comandos
-CommandResponse processCommand(const char* cmd) {
-  CommandResponse response = {false, "", ""};
-  
-  char functionCode;
-  char subCode;
-  char data[60];
-  int dataLen;
-  
-  if (!parseCommand(cmd, &functionCode, &subCode, data, &dataLen)) {
-    strcpy(response.message, "Comando inválido");
-    return response;
-  }
-  
-  // Procesar según el código de función
-  switch (functionCode) {
-    case 'A':
-      return processA_Command(subCode, data, dataLen);
-    case 'B':
-      return processB_Command(subCode, data, dataLen);
-    case 'C':
-      return processC_Command(subCode, data, dataLen);
-    case 'D':
-      return processD_Command(subCode, data, dataLen);
-    case 'E':
-      return processE_Command(subCode, data, dataLen);
-    case 'G':
-      return processG_Command(subCode, data, dataLen);
-    case 'H':
-      return processH_Command(subCode, data, dataLen);
-    case 'J':
-      return processJ_Command(subCode, data, dataLen);
-    case 'K':
-      return processK_Command(subCode, data, dataLen);
-    case 'M':
-      return processM_Command(subCode, data, dataLen);
-    case 'O':
-      return processO_Command(subCode, data, dataLen);
-    case 'P':
-      return processP_Command(subCode, data, dataLen);
-    case 'R':
-      return processR_Command(subCode, data, dataLen);
-    case 'S':
-      return processS_Command(subCode, data, dataLen);
-    case 'T':
-      return processT_Command(subCode, data, dataLen);
-    case 'V':
-      return processV_Command(subCode, data, dataLen);
-    case 'X':
-      return processX_Command(subCode, data, dataLen);
-    case 'Z':
-      return processZ_Command(subCode, data, dataLen);
-    default:
-      strcpy(response.message, "Código de función desconocido");
-      return response;
-  }
-}
-
-// Implementación de procesamiento de comandos tipo "A"
-CommandResponse processA_Command(char subCode, const char* data, int dataLen) {
-  CommandResponse response = {true, "", ""};
-  
-  switch (subCode) {
-    case '0':
-      // A0: Configurar número de dispositivo
-      if (dataLen >= 1) {
-        uint8_t newDeviceId = (ascii2hex(data[0]) << 4) | ascii2hex(data[1]);
-        saveDeviceId(newDeviceId);
-        config.deviceId = newDeviceId;
-        sprintf(config.deviceIdStr, "%02X", newDeviceId);
-        sendACK();
-        strcpy(response.message, "ID de dispositivo actualizado");
-      } else {
-        sendNAK();
-        response.success = false;
-        strcpy(response.message, "Datos insuficientes");
-      }
-      break;
-      
-    case '1':
-      // A1: Consultar número de dispositivo
-      sendData("A", "1", config.deviceIdStr);
-      sprintf(response.message, "ID de dispositivo: %s", config.deviceIdStr);
-      sprintf(response.data, "%s", config.deviceIdStr);
-      break;
-      
-    case '4':
-      // A4: Grabar nombre de la empresa en EEPROM
-      if (dataLen > 0) {
-        char name[17];
-        memcpy(name, data, min(dataLen, 16));
-        name[min(dataLen, 16)] = '\0';
-        saveCompanyName(name);
-        strcpy(config.nombre_empresa, name);
-        sendACK();
-        strcpy(response.message, "Nombre de empresa actualizado");
-      } else {
-        sendNAK();
-        response.success = false;
-        strcpy(response.message, "Datos insuficientes");
-      }
-      break;
-      
-    case '5':
-      // A5: Consultar nombre de la empresa
-      sendData("A", "5", config.nombre_empresa);
-      sprintf(response.message, "Nombre de empresa: %s", config.nombre_empresa);
-      sprintf(response.data, "%s", config.nombre_empresa);
-      break;
-      
-    case '6':
-      // A6: Configurar modo TCP/IP485
-      if (dataLen >= 2) {
-        uint8_t newMode = (ascii2hex(data[0]) << 4) | ascii2hex(data[1]);
-        saveTcpIpMode(newMode);
-        config.modo_tcpip485 = newMode;
-        sendACK();
-        sprintf(response.message, "Modo TCP/IP485 actualizado a %02X", newMode);
-      } else {
-        sendNAK();
-        response.success = false;
-        strcpy(response.message, "Datos insuficientes");
-      }
-      break;
-      
-    case '7':
-      // A7: Consultar modo TCP/IP485
-      {
-        char modeStr[3];
-        sprintf(modeStr, "%02X", config.modo_tcpip485);
-        sendData("A", "7", modeStr);
-        sprintf(response.message, "Modo TCP/IP485: %s", modeStr);
-        sprintf(response.data, "%s", modeStr);
-      }
-      break;
-      
-    case 'A':
-      // AA: Configurar Serial Number Byte 0 (solo ID 2)
-      if (config.deviceId == 2) {
-        if (dataLen >= 2) {
-          uint8_t serialNumber0 = (ascii2hex(data[0]) << 4) | ascii2hex(data[1]);
-          saveSerialNumber(0, serialNumber0);
-          sendACK();
-          sprintf(response.message, "Serial Number Byte 0 actualizado a %02X", serialNumber0);
-        } else {
-          sendNAK();
-          response.success = false;
-          strcpy(response.message, "Datos insuficientes");
-        }
-      } else {
-        sendNAK();
-        response.success = false;
-        strcpy(response.message, "Comando no permitido para este dispositivo");
-      }
-      break;
-      
-    default:
-      sendNAK();
-      response.success = false;
-      sprintf(response.message, "Subcódigo A%c desconocido", subCode);
-      break;
-  }
-  
-  return response;
-}
-
-// Implementación de funciones de envío de comandos
-bool sendCommand(const char* functionCode, const char* subCode, const char* data) {
-  char buffer[64];
-  int index = 0;
-  
-  // Construir comando
-  buffer[index++] = STX;
-  buffer[index++] = config.deviceIdStr[0];
-  buffer[index++] = config.deviceIdStr[1];
-  buffer[index++] = functionCode[0];
-  buffer[index++] = subCode[0];
-  
-  // Agregar datos si los hay
-  if (data != NULL) {
-    int dataLen = strlen(data);
-    for (int i = 0; i < dataLen && index < 62; i++) {
-      buffer[index++] = data[i];
-    }
-  }
-  
-  // Agregar ETX
-  buffer[index++] = ETX;
-  buffer[index] = '\0';
-  
-  // Enviar comando
-  return sendRawCommand(buffer);
-}
-
-bool sendRawCommand(const char* cmd) {
-  // Cambiar a modo TX
-  setTxMode();
-  
-  // Enviar comando por serial
-  rs485Serial.write(cmd, strlen(cmd));
-  rs485Serial.flush();
-  
-  // Cambiar a modo RX
-  setRxMode();
-  
-  return true;
-}
-
-// Implementación de funciones de respuesta estándar
-bool sendACK() {
-  char cmd[5];
-  cmd[0] = STX;
-  cmd[1] = config.deviceIdStr[0];
-  cmd[2] = config.deviceIdStr[1];
-  cmd[3] = ACK;
-  cmd[4] = ETX;
-  
-  return sendRawCommand(cmd);
-}
-
-bool sendNAK() {
-  char cmd[5];
-  cmd[0] = STX;
-  cmd[1] = config.deviceIdStr[0];
-  cmd[2] = config.deviceIdStr[1];
-  cmd[3] = NAK;
-  cmd[4] = ETX;
-  
-  return sendRawCommand(cmd);
-}
-
-bool sendStatus() {
-  char buffer[64];
-  int index = 0;
-  
-  // Construir respuesta de status
-  buffer[index++] = STX;
-  buffer[index++] = config.deviceIdStr[0];
-  buffer[index++] = config.deviceIdStr[1];
-  buffer[index++] = 'S';
-  buffer[index++] = '0';
-  
-  // Agregar status
-  updateStatusHexString();
-  for (int i = 0; i < 4; i++) {
-    buffer[index++] = statusInfo.statusHex[i];
-  }
-  
-  // Agregar datos RFID si hay
-  if (strlen(statusInfo.rfidData) > 0) {
-    for (int i = 0; i < strlen(statusInfo.rfidData); i++) {
-      buffer[index++] = statusInfo.rfidData[i];
-    }
-  }
-  
-  // Agregar SIB
-  buffer[index++] = SIB;
-  buffer[index] = '\0';
-  
-  return sendRawCommand(buffer);
-}
-
-bool sendData(const char* functionCode, const char* subCode, const char* data) {
-  char buffer[64];
-  int index = 0;
-  
-  // Construir respuesta con datos
-  buffer[index++] = STX;
-  buffer[index++] = config.deviceIdStr[0];
-  buffer[index++] = config.deviceIdStr[1];
-  buffer[index++] = functionCode[0];
-  buffer[index++] = subCode[0];
-  
-  // Agregar datos
-  int dataLen = strlen(data);
-  for (int i = 0; i < dataLen && index < 62; i++) {
-    buffer[index++] = data[i];
-  }
-  
-  // Agregar SIB
-  buffer[index++] = SIB;
-  buffer[index] = '\0';
-  
-  return sendRawCommand(buffer);
-}
-
-// Implementación de funciones para recepción de datos
-bool processIncomingByte(uint8_t byte) {
-  // Si es STX, iniciar un nuevo comando
-  if (byte == STX) {
-    cmdBuffer.index = 0;
-    cmdBuffer.buffer[cmdBuffer.index++] = byte;
-    cmdBuffer.complete = false;
-    return false;
-  }
-  
-  // Si es ETX, completar el comando
-  else if (byte == ETX) {
-    cmdBuffer.buffer[cmdBuffer.index++] = byte;
-    cmdBuffer.buffer[cmdBuffer.index] = '\0';
-    cmdBuffer.complete = true;
-    return true;
-  }
-  
-  // De lo contrario, agregar al buffer si hay espacio
-  else if (cmdBuffer.index < 63) {
-    cmdBuffer.buffer[cmdBuffer.index++] = byte;
-    return false;
-  }
-  
-  // Buffer overflow
-  return false;
-}
-
-void clearCommandBuffer() {
-  cmdBuffer.index = 0;
-  cmdBuffer.buffer[0] = '\0';
-  cmdBuffer.complete = false;
-}
-
-bool isCommandComplete() {
-  return cmdBuffer.complete;
-}
-
-const char* getCommand() {
-  return cmdBuffer.buffer;
-}
-
-// Implementación de funciones de relay
-bool activateRelay(int relayNum) {
-  if (relayNum < 1 || relayNum > 5) return false;
-  
-  RelayInfo* relay = &relays[relayNum - 1];
-  relay->state = 1;
-  
-  // Activar el pin (lógica invertida - activo en bajo)
-  digitalWrite(relay->pin, LOW);
-  
-  // Actualizar status
-  if (relayNum == 1) setStatusBit(STATUS_RELAY1);
-  else if (relayNum == 2) setStatusBit(STATUS_RELAY2);
-  
-  return true;
-}
-
-bool deactivateRelay(int relayNum) {
-  if (relayNum < 1 || relayNum > 5) return false;
-  
-  RelayInfo* relay = &relays[relayNum - 1];
-  relay->state = 0;
-  
-  // Desactivar el pin (lógica invertida - inactivo en alto)
-  digitalWrite(relay->pin, HIGH);
-  
-  // Actualizar status
-  if (relayNum == 1) clearStatusBit(STATUS_RELAY1);
-  else if (relayNum == 2) clearStatusBit(STATUS_RELAY2);
-  
-  return true;
-}
-
-bool setRelayTimer(int relayNum, uint8_t time) {
-    if (relayNum < 1 || relayNum > 5) return false;
-    
-    RelayInfo* relay = &relays[relayNum - 1];
-    relay->time = time;
-    
-    // Guardar el valor en EEPROM
-    saveRelayTimer(relayNum, time);
-    
-    return true;
-  }
-  
-  uint8_t getRelayTimer(int relayNum) {
-    if (relayNum < 1 || relayNum > 5) return 0;
-    
-    return relays[relayNum - 1].time;
-  }
-  
-  void updateRelays() {
-    // Esta función debe llamarse en cada ciclo del loop
-    // Gestiona los estados temporales de los relés
-    
-    for (int i = 0; i < 5; i++) {
-      RelayInfo* relay = &relays[i];
-      
-      // Si el relé está en un estado temporal (>1)
-      if (relay->state > 1) {
-        // Estado 2: Desactivación inmediata
-        if (relay->state == 2) {
-          digitalWrite(relay->pin, HIGH); // Desactivar (lógica invertida)
-          relay->state = 0;
-        }
-        // Estado 3: Pulso por tiempo definido
-        else if (relay->state == 3) {
-          digitalWrite(relay->pin, LOW); // Activar (lógica invertida)
-          relay->tmr_100ms = relay->time * 10; // Convertir a incrementos de 100ms
-          relay->state = 4; // Pasar al siguiente estado
-        }
-        // Estado 4: Esperando fin de pulso
-        else if (relay->state == 4) {
-          if (relay->tmr_100ms > 0) {
-            relay->tmr_100ms--;
-          } else {
-            digitalWrite(relay->pin, HIGH); // Desactivar (lógica invertida)
-            relay->state = 0;
-          }
-        }
-        // Estado 5: Activación por tiempo definido
-        else if (relay->state == 5) {
-          digitalWrite(relay->pin, LOW); // Activar (lógica invertida)
-          relay->tmr_100ms = relay->time * 10; // Convertir a incrementos de 100ms
-          relay->state = 6; // Pasar al siguiente estado
-        }
-        // Estado 6: Esperando fin de activación
-        else if (relay->state == 6) {
-          if (relay->tmr_100ms > 0) {
-            relay->tmr_100ms--;
-          } else {
-            digitalWrite(relay->pin, HIGH); // Desactivar (lógica invertida)
-            relay->state = 0;
-          }
-        }
-        // Estado 7: Activación permanente
-        else if (relay->state == 7) {
-          digitalWrite(relay->pin, LOW); // Activar (lógica invertida)
-          // Este estado permanece hasta que se cambie manualmente
-        }
-        // Otros estados especiales
-        else if (relay->state == 10 || relay->state == 20 || relay->state == 30 || relay->state == 45) {
-          digitalWrite(relay->pin, LOW); // Activar (lógica invertida)
-          relay->tmr_100ms = relay->state * 10; // Usar el propio estado como tiempo
-          relay->state = 6; // Pasar al estado de espera
-        }
-      }
-    }
-  }
-
-// Continuación de processP_Command
-
-        sprintf(response.message, "Tiempo presencia DDMM1 configurado a %d", DDMM1_TimePresent);
-      } else {
-        sendNAK();
-        response.success = false;
-        strcpy(response.message, "Datos insuficientes");
-      }
-      break;
-      
-    case '7':
-      // P7: Configurar tiempo de ausencia DDMM2
-      if (dataLen >= 2) {
-        DDMM2_TimeAbsent = (ascii2hex(data[0]) * 10) + ascii2hex(data[1]);
-        
-        sendACK();
-        sprintf(response.message, "Tiempo ausencia DDMM2 configurado a %d", DDMM2_TimeAbsent);
-      } else {
-        sendNAK();
-        response.success = false;
-        strcpy(response.message, "Datos insuficientes");
-      }
-      break;
-      
-    case '8':
-      // P8: Configurar tiempo de presencia DDMM2
-      if (dataLen >= 2) {
-        DDMM2_TimePresent = (ascii2hex(data[0]) * 10) + ascii2hex(data[1]);
-        
-        sendACK();
-        sprintf(response.message, "Tiempo presencia DDMM2 configurado a %d", DDMM2_TimePresent);
-      } else {
-        sendNAK();
-        response.success = false;
-        strcpy(response.message, "Datos insuficientes");
-      }
-      break;
-      
-    default:
-      sendNAK();
-      response.success = false;
-      sprintf(response.message, "Subcódigo P%c desconocido", subCode);
-      break;
-  }
-  
-  return response;
-}
-
-// Implementación de procesamiento de comandos tipo "R"
-CommandResponse processR_Command(char subCode, const char* data, int dataLen) {
-  CommandResponse response = {true, "", ""};
-  
-  switch (subCode) {
-    case '1':
-      // R1: Desactivar Relé 1
-      deactivateRelay(1);
-      sendACK();
-      strcpy(response.message, "Relé 1 desactivado");
-      break;
-      
-    case '2':
-      // R2: Desactivar Relé 2
-      deactivateRelay(2);
-      sendACK();
-      strcpy(response.message, "Relé 2 desactivado");
-      break;
-      
-    case '3':
-      // R3: Desactivar Relé 3
-      deactivateRelay(3);
-      sendACK();
-      strcpy(response.message, "Relé 3 desactivado");
-      break;
-      
-    case '4':
-      // R4: Desactivar Relé 4
-      deactivateRelay(4);
-      sendACK();
-      strcpy(response.message, "Relé 4 desactivado");
-      break;
-      
-    case '5':
-      // R5: Desactivar Relé 5
-      deactivateRelay(5);
-      sendACK();
-      strcpy(response.message, "Relé 5 desactivado");
-      break;
-      
-    case '6':
-      // R6: Indicar playa libre
-      deactivateRelay(2);
-      // Aquí podríamos establecer alguna variable de estado para playa llena
-      sendACK();
-      strcpy(response.message, "Playa libre, ingreso habilitado");
-      break;
-      
-    case '7':
-      // R7: Reiniciar estado lector/scanner
-      statusInfo.scannerActivo = true;
-      statusInfo.tarjetaLeida = false;
-      clearStatusBit(STATUS_TARJ);
-      clearStatusBit(STATUS_FRAUDE);
-      clearStatusBit(STATUS_PULS);
-      clearStatusBit(STATUS_SCANNER);
-      
-      relays[2].state = 1; // Activar relay 3
-      relays[0].tmr_100ms = 10; // Timer 1 segundo
-      relays[0].state = 0;
-      deactivateRelay(1);
-      
-      sendACK();
-      strcpy(response.message, "Estado lector/scanner reiniciado");
-      break;
-      
-    default:
-      sendNAK();
-      response.success = false;
-      sprintf(response.message, "Subcódigo R%c desconocido", subCode);
-      break;
-  }
-  
-  return response;
-}
-
-// Implementación de procesamiento de comandos tipo "S"
-CommandResponse processS_Command(char subCode, const char* data, int dataLen) {
-  CommandResponse response = {true, "", ""};
-  
-  switch (subCode) {
-    case '0':
-      // S0: Consultar status
-      sendStatus();
-      sprintf(response.message, "Status enviado: %s", statusInfo.statusHex);
-      break;
-      
-    case '1':
-      // S1: Activar Relé 1
-      activateRelay(1);
-      sendACK();
-      strcpy(response.message, "Relé 1 activado");
-      break;
-      
-    case '2':
-      // S2: Activar Relé 2
-      activateRelay(2);
-      sendACK();
-      strcpy(response.message, "Relé 2 activado");
-      break;
-      
-    case '3':
-      // S3: Activar Relé 3
-      activateRelay(3);
-      sendACK();
-      strcpy(response.message, "Relé 3 activado");
-      break;
-      
-    case '4':
-      // S4: Activar Relé 4
-      activateRelay(4);
-      sendACK();
-      strcpy(response.message, "Relé 4 activado");
-      break;
-      
-    case '5':
-      // S5: Activar Relé 5
-      activateRelay(5);
-      sendACK();
-      strcpy(response.message, "Relé 5 activado");
-      break;
-      
-    case '6':
-      // S6: Indicar playa llena
-      activateRelay(2);
-      // Aquí podríamos establecer alguna variable de estado para playa llena
-      sendACK();
-      strcpy(response.message, "Playa llena, ingreso inhibido");
-      break;
-      
-    case '7':
-      // S7: Activar barrera (Relé 1 estado 7)
-      relays[0].state = 7;
-      sendACK();
-      strcpy(response.message, "Barrera activada (estado 7)");
-      break;
-      
-    default:
-      sendNAK();
-      response.success = false;
-      sprintf(response.message, "Subcódigo S%c desconocido", subCode);
-      break;
-  }
-  
-  return response;
-}
-
-// Implementación de procesamiento de comandos tipo "T"
-CommandResponse processT_Command(char subCode, const char* data, int dataLen) {
-  CommandResponse response = {true, "", ""};
-  
-  // Variables para las líneas del ticket (deberían estar en un ámbito más amplio)
-  static char linea_1[17] = "Ticket Linea 1";
-  static char linea_2[17] = "Ticket Linea 2";
-  static char linea_3[17] = "Ticket Linea 3";
-  static char linea_4[17] = "Ticket Linea 4";
-  
-  switch (subCode) {
-    case '0':
-      // T0: Leer línea 1 del ticket
-      sendData("T", "0", linea_1);
-      sprintf(response.message, "Línea 1 de ticket enviada");
-      break;
-      
-    case '1':
-      // T1: Leer línea 2 del ticket
-      sendData("T", "1", linea_2);
-      sprintf(response.message, "Línea 2 de ticket enviada");
-      break;
-      
-    case '2':
-      // T2: Leer línea 3 del ticket
-      sendData("T", "2", linea_3);
-      sprintf(response.message, "Línea 3 de ticket enviada");
-      break;
-      
-    case '3':
-      // T3: Leer línea 4 del ticket
-      sendData("T", "3", linea_4);
-      sprintf(response.message, "Línea 4 de ticket enviada");
-      break;
-      
-    case '4':
-      // T4: Grabar línea 1 del ticket
-      if (dataLen >= 16) {
-        // Copiar los datos a la línea 1
-        memcpy(linea_1, data, 16);
-        linea_1[16] = '\0';
-        
-        // Guardar en EEPROM
-        saveTicketLine(1, linea_1);
-        
-        sendACK();
-        strcpy(response.message, "Línea 1 de ticket grabada");
-      } else {
-        sendNAK();
-        response.success = false;
-        strcpy(response.message, "Datos insuficientes");
-      }
-      break;
-      
-    case '5':
-      // T5: Grabar línea 2 del ticket
-      if (dataLen >= 16) {
-        // Copiar los datos a la línea 2
-        memcpy(linea_2, data, 16);
-        linea_2[16] = '\0';
-        
-        // Guardar en EEPROM
-        saveTicketLine(2, linea_2);
-        
-        sendACK();
-        strcpy(response.message, "Línea 2 de ticket grabada");
-      } else {
-        sendNAK();
-        response.success = false;
-        strcpy(response.message, "Datos insuficientes");
-      }
-      break;
-      
-    case '6':
-      // T6: Grabar línea 3 del ticket
-      if (dataLen >= 16) {
-        // Copiar los datos a la línea 3
-        memcpy(linea_3, data, 16);
-        linea_3[16] = '\0';
-        
-        // Guardar en EEPROM
-        saveTicketLine(3, linea_3);
-        
-        sendACK();
-        strcpy(response.message, "Línea 3 de ticket grabada");
-      } else {
-        sendNAK();
-        response.success = false;
-        strcpy(response.message, "Datos insuficientes");
-      }
-      break;
-      
-    case '7':
-      // T7: Grabar línea 4 del ticket
-      if (dataLen >= 16) {
-        // Copiar los datos a la línea 4
-        memcpy(linea_4, data, 16);
-        linea_4[16] = '\0';
-        
-        // Guardar en EEPROM
-        saveTicketLine(4, linea_4);
-        
-        sendACK();
-        strcpy(response.message, "Línea 4 de ticket grabada");
-      } else {
-        sendNAK();
-        response.success = false;
-        strcpy(response.message, "Datos insuficientes");
-      }
-      break;
-      
-    case '9':
-      // T9: Imprimir ticket e informar número generado
-      {
-        // Aquí deberíamos generar un número de ticket
-        // Por ahora generamos uno aleatorio para demostración
-        char ticket[13];
-        sprintf(ticket, "%012d", random(1, 1000000));
-        
-        // Enviar respuesta
-        sendData("T", "9", ticket);
-        
-        sprintf(response.message, "Ticket generado: %s", ticket);
-        strncpy(response.data, ticket, sizeof(response.data) - 1);
-        response.data[sizeof(response.data) - 1] = '\0';
-      }
-      break;
-      
-    default:
-      sendNAK();
-      response.success = false;
-      sprintf(response.message, "Subcódigo T%c desconocido", subCode);
-      break;
-  }
-  
-  return response;
-}
-
-// Implementación de procesamiento de comandos tipo "V"
-CommandResponse processV_Command(char subCode, const char* data, int dataLen) {
-  CommandResponse response = {true, "", ""};
-  
-  switch (subCode) {
-    case '0':
-      // V0: Consultar versión
-      {
-        // Enviar versión del firmware
-        char version[] = "OemProxy v1.0";
-        sendData("V", "0", version);
-        
-        strcpy(response.message, "Versión enviada");
-        strcpy(response.data, version);
-      }
-      break;
-      
-    default:
-      sendNAK();
-      response.success = false;
-      sprintf(response.message, "Subcódigo V%c desconocido", subCode);
-      break;
-  }
-  
-  return response;
-}
-
-// Implementación de procesamiento de comandos tipo "X"
-CommandResponse processX_Command(char subCode, const char* data, int dataLen) {
-  CommandResponse response = {true, "", ""};
-  
-  switch (subCode) {
-    case '0':
-      // X0: Reiniciar dispositivo
-      sendACK();
-      strcpy(response.message, "Reiniciando dispositivo...");
-      
-      // Programar reinicio en 1 segundo para permitir enviar la respuesta
-      #ifdef ESP8266
-        ESP.wdtDisable();
-        ESP.restart();
-      #elif defined(ESP32)
-        ESP.restart();
-      #endif
-      break;
-      
-    case '9':
-      // X9: Reiniciar dispositivo (alternativo)
-      sendACK();
-      strcpy(response.message, "Reiniciando dispositivo...");
-      
-      // Programar reinicio en 1 segundo para permitir enviar la respuesta
-      #ifdef ESP8266
-        ESP.wdtDisable();
-        ESP.restart();
-      #elif defined(ESP32)
-        ESP.restart();
-      #endif
-      break;
-      
-    default:
-      sendNAK();
-      response.success = false;
-      sprintf(response.message, "Subcódigo X%c desconocido", subCode);
-      break;
-  }
-  
-  return response;
-}
-
-// Implementación de procesamiento de comandos tipo "Z"
-CommandResponse processZ_Command(char subCode, const char* data, int dataLen) {
-  CommandResponse response = {true, "", ""};
-  
-  switch (subCode) {
-    case '0':
-      // Z0: Configurar códigos de barras
-      if (dataLen >= 4) {
-        // Formato: unidad_mil + 3 dígitos
-        char unidadMil = data[0];
-        char counter[4] = {data[1], data[2], data[3], '\0'};
-        
-        // Guardar en EEPROM o variables globales
-        
-        sendACK();
-        sprintf(response.message, "Código de barras configurado: %c%s", unidadMil, counter);
-      } else {
-        sendNAK();
-        response.success = false;
-        strcpy(response.message, "Datos insuficientes");
-      }
-      break;
-      
-    case '1':
-      // Z1: Consultar configuración de códigos de barras
-      {
-        // Deberíamos leer estos valores de EEPROM o variables globales
-        // Por ahora enviamos valores estáticos
-        char config[] = "A123";
-        
-        sendData("Z", "1", config);
-        sprintf(response.message, "Configuración de código de barras: %s", config);
-      }
-      break;
-      
-    case '9':
-      // Z9: Mostrar configuración
-      {
-        // Aquí deberíamos tener código para mostrar la configuración en el display
-        // Por ahora solo respondemos con ACK
-        
-        sendACK();
-        strcpy(response.message, "Configuración mostrada en display");
-      }
-      break;
-      
-    default:
-      sendNAK();
-      response.success = false;
-      sprintf(response.message, "Subcódigo Z%c desconocido", subCode);
-      break;
-  }
-  
-  return response;
+#include "protocolo.h"
+#include "utilidades.h"
+#include "almacenamiento.h"
+#include "rs485.h"
+#include "memoria.h"
+#include "mensajes.h"
+#include "metricas.h"
+#include <Arduino.h>
+
+// Destino de las respuestas mientras se ejecuta un comando (NULL = bus RS485)
+static Print* responseSink = NULL;
+
+// Reinicio pedido por X0/X9: se difiere para que la respuesta llegue por
+// cualquier transporte (bus, REST, web) antes de reiniciar
+static bool restartPending = false;
+static unsigned long restartAt = 0;
+
+// Bit de status de cada relé (el protocolo solo define los relés 1 y 2)
+static const uint16_t relayStatusBits[5] = {STATUS_RELAY1, STATUS_RELAY2, 0, 0, 0};
+
+// Único punto que mueve la salida de un relé y su bit de status
+static void setRelayOutput(int index, bool on) {
+  digitalWrite(relays[index].pin, on ? LOW : HIGH); // Lógica invertida: activo en bajo
+  
+  if (relayStatusBits[index] == 0) return;
+  if (on) setStatusBit(relayStatusBits[index]);
+  else clearStatusBit(relayStatusBits[index]);
+}
+
+// Volver el lector/scanner al estado de espera de una nueva lectura
+static void resetScannerState() {
+  statusInfo.scannerActivo = true;
+  statusInfo.tarjetaLeida = false;
+  clearStatusBit(STATUS_TARJ);
+  clearStatusBit(STATUS_FRAUDE);
+  clearStatusBit(STATUS_PULS);
+  clearStatusBit(STATUS_SCANNER);
+}
+
+// Respuestas ya armadas de las consultas de solo lectura
+// Sus datos solo cambian con la configuración: se arman una vez y se
+// descartan todas juntas cuando cambia configVersion
+#define REPLY_A1        0
+#define REPLY_A5        1
+#define REPLY_A7        2
+#define REPLY_T0        3   // T0-T3 ocupan cuatro lugares seguidos
+#define REPLY_V0        7
+#define REPLY_Z1        8
+#define CACHED_REPLIES  9
+
+typedef struct {
+  char frame[64];              // STX + ID + código + datos + SIB
+  uint8_t length;              // 0 = sin armar
+} CachedReply;
+
+static CachedReply cachedReplies[CACHED_REPLIES];
+static uint32_t cachedRepliesVersion = 0;
+
+static bool sendFrame(const char* frame, size_t length);
+static size_t buildDataFrame(char* buffer, const char* functionCode, const char* subCode, const char* data);
+
+// Enviar la respuesta guardada; false si hay que armarla
+static bool sendCachedReply(uint8_t slot) {
+  if (cachedRepliesVersion != configVersion) {
+    for (int i = 0; i < CACHED_REPLIES; i++) {
+      cachedReplies[i].length = 0;
+    }
+    cachedRepliesVersion = configVersion;
+  }
+  
+  if (cachedReplies[slot].length == 0) return false;
+  
+  sendFrame(cachedReplies[slot].frame, cachedReplies[slot].length);
+  return true;
+}
+
+// Como sendData, pero guardando la trama para las próximas consultas
+static bool sendCachedData(uint8_t slot, const char* functionCode, const char* subCode, const char* data) {
+  CachedReply& reply = cachedReplies[slot];
+  reply.length = buildDataFrame(reply.frame, functionCode, subCode, data);
+  return sendFrame(reply.frame, reply.length);
+}
+
+// Guardar lo pendiente y programar el reinicio
+static void scheduleRestart() {
+  flushTicketCounter();
+  syncStorage();
+  
+  restartPending = true;
+  restartAt = millis() + RESTART_DELAY_MS;
+}
+
+// Implementación de funciones de parsing de comandos
+bool parseCommand(const char* cmd, char* functionCode, char* subCode, char* data, int* dataLen) {
+  // Verificar longitud mínima (STX + ID[2] + FUNC + SUBFUNC + ETX = 6)
+  int len = strlen(cmd);
+  if (len < 6) {
+    metrics.framesDropped[DROP_INVALID]++;
+    return false;
+  }
+  
+  // Verificar STX y ETX
+  if (cmd[0] != STX || cmd[len-1] != ETX) {
+    metrics.framesDropped[DROP_INVALID]++;
+    return false;
+  }
+  
+  // Extraer ID del dispositivo (2 caracteres)
+  char deviceIdStr[3] = {cmd[1], cmd[2], '\0'};
+  
+  // Verificar si el comando es para este dispositivo
+  if (strcmp(deviceIdStr, config.deviceIdStr) != 0) {
+    metrics.framesDropped[DROP_OTHER_DEVICE]++;
+    return false;
+  }
+  
+  // Extraer código de función y subfunción
+  *functionCode = cmd[3];
+  *subCode = cmd[4];
+  
+  // Extraer datos si hay
+  *dataLen = len - 6; // STX + ID[2] + FUNC + SUBFUNC + ETX = 6
+  if (*dataLen > 0) {
+    memcpy(data, &cmd[5], *dataLen);
+    data[*dataLen] = '\0';
+  } else {
+    data[0] = '\0';
+  }
+  
+  return true;
+}
+
+bool validateCommand(const char* cmd, int len) {
+  // Verificar longitud mínima
+  if (len < 6) return false;
+  
+  // Verificar STX y ETX
+  if (cmd[0] != STX || cmd[len-1] != ETX) return false;
+  
+  // Aquí se podría agregar verificación de checksum si el protocolo lo usa
+  
+  return true;
+}
+
+// Implementación de funciones para procesar comandos
+CommandResponse processCommand(const char* cmd) {
+  CommandResponse response = {false, MSG_NONE, 0, ""};
+  
+  char functionCode;
+  char subCode;
+  char data[60];
+  int dataLen;
+  
+  if (!parseCommand(cmd, &functionCode, &subCode, data, &dataLen)) {
+    setMessage(response, MSG_INVALID_COMMAND);
+    return response;
+  }
+  
+  // Procesar según el código de función
+  // Las familias que el perfil no incluye (perfil.h) quedan como desconocidas;
+  // hasCommandFamily() es constexpr y el compilador descarta sus procesadores
+  bool dispatched = true;
+  switch (functionCode) {
+    case 'A':
+      if (hasCommandFamily('A')) response = processA_Command(subCode, data, dataLen);
+      else dispatched = false;
+      break;
+    case 'B':
+      if (hasCommandFamily('B')) response = processB_Command(subCode, data, dataLen);
+      else dispatched = false;
+      break;
+    case 'C':
+      if (hasCommandFamily('C')) response = processC_Command(subCode, data, dataLen);
+      else dispatched = false;
+      break;
+    case 'D':
+      if (hasCommandFamily('D')) response = processD_Command(subCode, data, dataLen);
+      else dispatched = false;
+      break;
+    case 'E':
+      if (hasCommandFamily('E')) response = processE_Command(subCode, data, dataLen);
+      else dispatched = false;
+      break;
+    case 'G':
+      if (hasCommandFamily('G')) response = processG_Command(subCode, data, dataLen);
+      else dispatched = false;
+      break;
+    case 'H':
+      if (hasCommandFamily('H')) response = processH_Command(subCode, data, dataLen);
+      else dispatched = false;
+      break;
+    case 'J':
+      if (hasCommandFamily('J')) response = processJ_Command(subCode, data, dataLen);
+      else dispatched = false;
+      break;
+    case 'K':
+      if (hasCommandFamily('K')) response = processK_Command(subCode, data, dataLen);
+      else dispatched = false;
+      break;
+    case 'M':
+      if (hasCommandFamily('M')) response = processM_Command(subCode, data, dataLen);
+      else dispatched = false;
+      break;
+    case 'O':
+      if (hasCommandFamily('O')) response = processO_Command(subCode, data, dataLen);
+      else dispatched = false;
+      break;
+    case 'P':
+      if (hasCommandFamily('P')) response = processP_Command(subCode, data, dataLen);
+      else dispatched = false;
+      break;
+    case 'R':
+      if (hasCommandFamily('R')) response = processR_Command(subCode, data, dataLen);
+      else dispatched = false;
+      break;
+    case 'S':
+      if (hasCommandFamily('S')) response = processS_Command(subCode, data, dataLen);
+      else dispatched = false;
+      break;
+    case 'T':
+      if (hasCommandFamily('T')) response = processT_Command(subCode, data, dataLen);
+      else dispatched = false;
+      break;
+    case 'V':
+      if (hasCommandFamily('V')) response = processV_Command(subCode, data, dataLen);
+      else dispatched = false;
+      break;
+    case 'X':
+      if (hasCommandFamily('X')) response = processX_Command(subCode, data, dataLen);
+      else dispatched = false;
+      break;
+    case 'Z':
+      if (hasCommandFamily('Z')) response = processZ_Command(subCode, data, dataLen);
+      else dispatched = false;
+      break;
+    default:
+      dispatched = false;
+      break;
+  }
+  
+  if (!dispatched) {
+    metrics.framesDropped[DROP_UNKNOWN_FUNCTION]++;
+    setMessage(response, MSG_UNKNOWN_FUNCTION);
+    return response;
+  }
+  
+  metrics.framesProcessed++;
+  metrics.commands[functionCode - 'A']++;
+  return response;
+}
+
+// Ejecutar un comando recibido fuera del bus
+CommandResponse executeCommand(const char* command, Print& reply) {
+  char frame[64];
+  
+  if (command[0] == STX) {
+    safeStrCopy(frame, command, sizeof(frame));
+  } else {
+    // Forma corta: agregar STX, ID propio y ETX
+    snprintf(frame, sizeof(frame) - 1, "%c%s%s", STX, config.deviceIdStr, command);
+    size_t len = strlen(frame);
+    frame[len++] = ETX;
+    frame[len] = '\0';
+  }
+  
+  Print* previous = responseSink;
+  setResponseSink(&reply);
+  CommandResponse response = processCommand(frame);
+  setResponseSink(previous);
+  
+  return response;
+}
+
+void setResponseSink(Print* sink) {
+  responseSink = sink;
+}
+
+// Implementación de procesamiento de comandos tipo "A"
+CommandResponse processA_Command(char subCode, const char* data, int dataLen) {
+  CommandResponse response = {true, MSG_NONE, 0, ""};
+  
+  switch (subCode) {
+    case '0':
+      // A0: Configurar número de dispositivo
+      if (dataLen >= 1) {
+        uint8_t newDeviceId = (ascii2hex(data[0]) << 4) | ascii2hex(data[1]);
+        saveDeviceId(newDeviceId);
+        config.deviceId = newDeviceId;
+        sprintf(config.deviceIdStr, "%02X", newDeviceId);
+        sendACK();
+        setMessage(response, MSG_DEVICE_ID_SET);
+      } else {
+        sendNAK();
+        response.success = false;
+        setMessage(response, MSG_NOT_ENOUGH_DATA);
+      }
+      break;
+      
+    case '1':
+      // A1: Consultar número de dispositivo
+      if (!sendCachedReply(REPLY_A1)) sendCachedData(REPLY_A1, "A", "1", config.deviceIdStr);
+      setMessage(response, MSG_DEVICE_ID);
+      safeStrCopy(response.data, config.deviceIdStr, sizeof(response.data));
+      break;
+      
+    case '4':
+      // A4: Grabar nombre de la empresa en EEPROM
+      if (dataLen > 0) {
+        char name[17];
+        memcpy(name, data, min(dataLen, 16));
+        name[min(dataLen, 16)] = '\0';
+        saveCompanyName(name);
+        strcpy(config.nombre_empresa, name);
+        sendACK();
+        setMessage(response, MSG_COMPANY_SET);
+      } else {
+        sendNAK();
+        response.success = false;
+        setMessage(response, MSG_NOT_ENOUGH_DATA);
+      }
+      break;
+      
+    case '5':
+      // A5: Consultar nombre de la empresa
+      if (!sendCachedReply(REPLY_A5)) sendCachedData(REPLY_A5, "A", "5", config.nombre_empresa);
+      setMessage(response, MSG_COMPANY);
+      safeStrCopy(response.data, config.nombre_empresa, sizeof(response.data));
+      break;
+      
+    case '6':
+      // A6: Configurar modo TCP/IP485
+      if (dataLen >= 2) {
+        uint8_t newMode = (ascii2hex(data[0]) << 4) | ascii2hex(data[1]);
+        saveTcpIpMode(newMode);
+        config.modo_tcpip485 = newMode;
+        sendACK();
+        setMessage(response, MSG_TCP_MODE_SET, newMode);
+      } else {
+        sendNAK();
+        response.success = false;
+        setMessage(response, MSG_NOT_ENOUGH_DATA);
+      }
+      break;
+      
+    case '7':
+      // A7: Consultar modo TCP/IP485
+      {
+        char modeStr[3];
+        sprintf(modeStr, "%02X", config.modo_tcpip485);
+        if (!sendCachedReply(REPLY_A7)) sendCachedData(REPLY_A7, "A", "7", modeStr);
+        setMessage(response, MSG_TCP_MODE);
+        strcpy(response.data, modeStr);
+      }
+      break;
+      
+    case 'A':
+      // AA: Configurar Serial Number Byte 0 (solo ID 2)
+      if (config.deviceId == 2) {
+        if (dataLen >= 2) {
+          uint8_t serialNumber0 = (ascii2hex(data[0]) << 4) | ascii2hex(data[1]);
+          saveSerialNumber(0, serialNumber0);
+          sendACK();
+          setMessage(response, MSG_SERIAL0_SET, serialNumber0);
+        } else {
+          sendNAK();
+          response.success = false;
+          setMessage(response, MSG_NOT_ENOUGH_DATA);
+        }
+      } else {
+        sendNAK();
+        response.success = false;
+        setMessage(response, MSG_NOT_ALLOWED);
+      }
+      break;
+      
+    default:
+      sendNAK();
+      response.success = false;
+      setMessage(response, MSG_UNKNOWN_SUBCODE, messageCode('A', subCode));
+      break;
+  }
+  
+  return response;
+}
+
+// Implementación de procesamiento de comandos tipo "C"
+CommandResponse processC_Command(char subCode, const char* data, int dataLen) {
+  CommandResponse response = {true, MSG_NONE, 0, ""};
+  
+  switch (subCode) {
+    case '1':
+      // C1: Habilitar scanner (reinicia la lectura y libera el relé 1)
+      resetScannerState();
+      relays[0].state = 2; // Desactivación en el próximo updateRelays()
+      sendACK();
+      setMessage(response, MSG_SCANNER_ENABLED);
+      break;
+      
+    case '5':
+      // C5: Activar molinete por pulso (relé 1 durante su tiempo configurado)
+      relays[0].state = 3;
+      metrics.relayActuations[0]++;
+      sendACK();
+      setMessage(response, MSG_TURNSTILE_PULSE);
+      break;
+      
+    default:
+      sendNAK();
+      response.success = false;
+      setMessage(response, MSG_UNKNOWN_SUBCODE, messageCode('C', subCode));
+      break;
+  }
+  
+  return response;
+}
+
+// Ejecutar el reinicio programado por X0/X9 (llamar periódicamente)
+void restartLoop() {
+  if (!restartPending || (long)(millis() - restartAt) < 0) return;
+  
+  #ifdef ESP8266
+    ESP.wdtDisable();
+  #endif
+  ESP.restart();
+}
+
+// Implementación de funciones de envío de comandos
+bool sendCommand(const char* functionCode, const char* subCode, const char* data) {
+  char buffer[64];
+  int index = 0;
+  
+  // Construir comando
+  buffer[index++] = STX;
+  buffer[index++] = config.deviceIdStr[0];
+  buffer[index++] = config.deviceIdStr[1];
+  buffer[index++] = functionCode[0];
+  buffer[index++] = subCode[0];
+  
+  // Agregar datos si los hay
+  if (data != NULL) {
+    int dataLen = strlen(data);
+    for (int i = 0; i < dataLen && index < 62; i++) {
+      buffer[index++] = data[i];
+    }
+  }
+  
+  // Agregar ETX
+  buffer[index++] = ETX;
+  buffer[index] = '\0';
+  
+  // Enviar comando
+  return sendRawCommand(buffer);
+}
+
+bool sendRawCommand(const char* cmd) {
+  return sendFrame(cmd, strlen(cmd));
+}
+
+static bool sendFrame(const char* frame, size_t length) {
+  // Comando de origen REST: la respuesta va al llamador, no al bus
+  if (responseSink != NULL) {
+    responseSink->write((const uint8_t*)frame, length);
+    return true;
+  }
+  
+  // Cambiar a modo TX
+  setTxMode();
+  
+  // Enviar comando por serial
+  rs485Serial.write(frame, length);
+  rs485Serial.flush();
+  
+  // Cambiar a modo RX
+  setRxMode();
+  
+  return true;
+}
+
+// Implementación de funciones de respuesta estándar
+bool sendACK() {
+  char cmd[5];
+  cmd[0] = STX;
+  cmd[1] = config.deviceIdStr[0];
+  cmd[2] = config.deviceIdStr[1];
+  cmd[3] = ACK;
+  cmd[4] = ETX;
+  
+  metrics.ackSent++;
+  return sendRawCommand(cmd);
+}
+
+bool sendNAK() {
+  char cmd[5];
+  cmd[0] = STX;
+  cmd[1] = config.deviceIdStr[0];
+  cmd[2] = config.deviceIdStr[1];
+  cmd[3] = NAK;
+  cmd[4] = ETX;
+  
+  metrics.nakSent++;
+  return sendRawCommand(cmd);
+}
+
+bool sendStatus() {
+  char buffer[64];
+  int index = 0;
+  
+  // Construir respuesta de status
+  buffer[index++] = STX;
+  buffer[index++] = config.deviceIdStr[0];
+  buffer[index++] = config.deviceIdStr[1];
+  buffer[index++] = 'S';
+  buffer[index++] = '0';
+  
+  // Agregar status
+  updateStatusHexString();
+  for (int i = 0; i < 4; i++) {
+    buffer[index++] = statusInfo.statusHex[i];
+  }
+  
+  // Agregar datos RFID si hay
+  if (strlen(statusInfo.rfidData) > 0) {
+    for (int i = 0; i < strlen(statusInfo.rfidData); i++) {
+      buffer[index++] = statusInfo.rfidData[i];
+    }
+  }
+  
+  // Agregar SIB
+  buffer[index++] = SIB;
+  buffer[index] = '\0';
+  
+  return sendRawCommand(buffer);
+}
+
+bool sendData(const char* functionCode, const char* subCode, const char* data) {
+  char buffer[64];
+  size_t length = buildDataFrame(buffer, functionCode, subCode, data);
+  return sendFrame(buffer, length);
+}
+
+// Armar la trama de respuesta con datos en buffer (64 bytes); devuelve su largo
+static size_t buildDataFrame(char* buffer, const char* functionCode, const char* subCode, const char* data) {
+  size_t index = 0;
+  
+  // Construir respuesta con datos
+  buffer[index++] = STX;
+  buffer[index++] = config.deviceIdStr[0];
+  buffer[index++] = config.deviceIdStr[1];
+  buffer[index++] = functionCode[0];
+  buffer[index++] = subCode[0];
+  
+  // Agregar datos
+  for (int i = 0; data[i] != '\0' && index < 62; i++) {
+    buffer[index++] = data[i];
+  }
+  
+  // Agregar SIB
+  buffer[index++] = SIB;
+  buffer[index] = '\0';
+  
+  return index;
+}
+
+// Implementación de funciones para recepción de datos
+// Fin de trama: ETX, o SIB si el buffer espera respuestas de datos de otro
+// equipo (las arma sendDataResponse / buildDataFrame)
+static inline bool isFrameEnd(const CommandBuffer& frame, uint8_t byte) {
+  return byte == ETX || (byte == SIB && frame.endOnSib);
+}
+
+// Armado de tramas STX..ETX sobre un buffer dado (bus RS485 o conexión TCP)
+bool frameIncomingByte(CommandBuffer& frame, uint8_t byte) {
+  // Si es STX, iniciar un nuevo comando
+  if (byte == STX) {
+    // Trama anterior sin ETX
+    if (frame.index > 0 && !frame.complete) countMetric(metrics.framesDropped[DROP_INCOMPLETE]);
+    
+    frame.index = 0;
+    frame.buffer[frame.index++] = byte;
+    frame.complete = false;
+    frame.overflow = false;
+    return false;
+  }
+  
+  // Si es ETX (o SIB), completar el comando
+  else if (isFrameEnd(frame, byte)) {
+    countMetric(metrics.framesReceived);
+    
+    // Una trama truncada no se procesa
+    if (frame.overflow) {
+      countMetric(metrics.framesDropped[DROP_OVERFLOW]);
+      resetFrame(frame);
+      return false;
+    }
+    
+    frame.buffer[frame.index++] = byte;
+    frame.buffer[frame.index] = '\0';
+    frame.complete = true;
+    return true;
+  }
+  
+  // De lo contrario, agregar al buffer si hay espacio (reservando ETX y '\0')
+  else if (frame.index < sizeof(frame.buffer) - 2) {
+    frame.buffer[frame.index++] = byte;
+    return false;
+  }
+  
+  // Buffer overflow
+  frame.overflow = true;
+  return false;
+}
+
+bool processIncomingByte(uint8_t byte) {
+  return frameIncomingByte(cmdBuffer, byte);
+}
+
+// Procesar un bloque recibido de una vez (normalmente una trama completa)
+// Los datos entre STX y el fin de trama se copian en tramos; los delimitadores
+// siguen la misma lógica que processIncomingByte. Se detiene después de
+// completar una trama para que se despache antes del resto: devuelve los
+// bytes consumidos
+size_t processIncomingBlock(const uint8_t* data, size_t len) {
+  size_t i = 0;
+  
+  while (i < len) {
+    if (data[i] == STX || isFrameEnd(cmdBuffer, data[i])) {
+      if (processIncomingByte(data[i++])) break;
+      continue;
+    }
+    
+    // Tramo de datos hasta el próximo delimitador
+    size_t run = 1;
+    while (i + run < len && data[i + run] != STX && !isFrameEnd(cmdBuffer, data[i + run])) run++;
+    
+    size_t limit = sizeof(cmdBuffer.buffer) - 2;
+    size_t room = cmdBuffer.index < limit ? limit - cmdBuffer.index : 0;
+    size_t copy = min(run, room);
+    memcpy(&cmdBuffer.buffer[cmdBuffer.index], data + i, copy);
+    cmdBuffer.index += copy;
+    if (copy < run) cmdBuffer.overflow = true;
+    
+    i += run;
+  }
+  
+  return i;
+}
+
+void resetFrame(CommandBuffer& frame) {
+  frame.index = 0;
+  frame.buffer[0] = '\0';
+  frame.complete = false;
+  frame.overflow = false;
+}
+
+void clearCommandBuffer() {
+  resetFrame(cmdBuffer);
+}
+
+void setBusFrameEndOnSib(bool enabled) {
+  cmdBuffer.endOnSib = enabled;
+}
+
+bool isCommandComplete() {
+  return cmdBuffer.complete;
+}
+
+const char* getCommand() {
+  return cmdBuffer.buffer;
+}
+
+size_t getProtocolRam() {
+  return sizeof(cmdBuffer) + sizeof(cachedReplies);
+}
+
+// Implementación de funciones de relay
+bool activateRelay(int relayNum) {
+  if (relayNum < 1 || relayNum > RELAY_COUNT) return false;
+  
+  relays[relayNum - 1].state = 1;
+  metrics.relayActuations[relayNum - 1]++;
+  setRelayOutput(relayNum - 1, true);
+  
+  return true;
+}
+
+bool deactivateRelay(int relayNum) {
+  if (relayNum < 1 || relayNum > RELAY_COUNT) return false;
+  
+  relays[relayNum - 1].state = 0;
+  setRelayOutput(relayNum - 1, false);
+  
+  return true;
+}
+
+// Cambio de configuración de POST /api/config
+// Corre en la tarea de protocolo, igual que los comandos A0/A4/A6: la tarea
+// web solo arma el pedido. Los modos que se leen al arrancar se graban pero
+// recién rigen después de reiniciar (arg de MSG_CONFIG_UPDATED)
+CommandResponse applyConfigUpdate(const ConfigUpdate& update) {
+  CommandResponse response = {true, MSG_NONE, 0, ""};
+  const DeviceConfig& next = update.config;
+  bool needsRestart = false;
+  
+  // Agrupar todas las escrituras en un único commit a flash
+  beginStorageTransaction();
+  
+  if ((update.fields & CONFIG_UPDATE_DEVICE_ID) && next.deviceId != config.deviceId) {
+    saveDeviceId(next.deviceId);
+    needsRestart = true;
+  }
+  
+  if (update.fields & CONFIG_UPDATE_COMPANY) {
+    saveCompanyName(next.nombre_empresa);
+    strcpy(config.nombre_empresa, next.nombre_empresa);
+  }
+  
+  if ((update.fields & CONFIG_UPDATE_TCPIP_MODE) && next.modo_tcpip485 != config.modo_tcpip485) {
+    saveTcpIpMode(next.modo_tcpip485);
+    needsRestart = true;
+  }
+  
+  if ((update.fields & CONFIG_UPDATE_WORK_MODE) && next.modo_work != config.modo_work) {
+    saveWorkMode(next.modo_work);
+    needsRestart = true;
+  }
+  
+  if ((update.fields & CONFIG_UPDATE_DISPLAY_MODE) && next.modo_display != config.modo_display) {
+    saveDisplayMode(next.modo_display);
+    needsRestart = true;
+  }
+  
+  if ((update.fields & CONFIG_UPDATE_QR_MODE) && next.modo_QR_8_12 != config.modo_QR_8_12) {
+    saveQRMode(next.modo_QR_8_12);
+    needsRestart = true;
+  }
+  
+  if ((update.fields & CONFIG_UPDATE_CLOCK_MODE) && next.modo_clock != config.modo_clock) {
+    saveClockMode(next.modo_clock);
+    needsRestart = true;
+  }
+  
+  if ((update.fields & CONFIG_UPDATE_SENSOR_MODE) && next.modo_sens_altura != config.modo_sens_altura) {
+    saveSensorMode(next.modo_sens_altura);
+    needsRestart = true;
+  }
+  
+  if (update.fields & CONFIG_UPDATE_ENTRANCE) {
+    // No se graba: al arrancar se deduce del modo de trabajo
+    config.esPuertaEntrada = next.esPuertaEntrada;
+    configVersion++;
+  }
+  
+  for (int i = 0; i < RELAY_COUNT; i++) {
+    if (update.relayMask & (1 << i)) setRelayTimer(i + 1, update.relayTime[i]);
+  }
+  
+  commitStorageTransaction();
+  
+  setMessage(response, MSG_CONFIG_UPDATED, needsRestart ? 1 : 0);
+  return response;
+}
+
+bool setRelayTimer(int relayNum, uint8_t time) {
+    if (relayNum < 1 || relayNum > RELAY_COUNT) return false;
+    
+    RelayInfo* relay = &relays[relayNum - 1];
+    relay->time = time;
+    
+    // Guardar el valor en EEPROM
+    saveRelayTimer(relayNum, time);
+    
+    return true;
+  }
+  
+  uint8_t getRelayTimer(int relayNum) {
+    if (relayNum < 1 || relayNum > RELAY_COUNT) return 0;
+    
+    return relays[relayNum - 1].time;
+  }
+  
+  void updateRelays() {
+    // Esta función debe llamarse en cada ciclo del loop
+    // Gestiona los estados temporales de los relés
+    
+    for (int i = 0; i < RELAY_COUNT; i++) {
+      RelayInfo* relay = &relays[i];
+      
+      // Si el relé está en un estado temporal (>1)
+      if (relay->state > 1) {
+        // Estado 2: Desactivación inmediata
+        if (relay->state == 2) {
+          setRelayOutput(i, false);
+          relay->state = 0;
+        }
+        // Estado 3: Pulso por tiempo definido
+        else if (relay->state == 3) {
+          setRelayOutput(i, true);
+          relay->tmr_100ms = relay->time * 10; // Convertir a incrementos de 100ms
+          relay->state = 4; // Pasar al siguiente estado
+        }
+        // Estado 4: Esperando fin de pulso
+        else if (relay->state == 4) {
+          if (relay->tmr_100ms > 0) {
+            relay->tmr_100ms--;
+          } else {
+            setRelayOutput(i, false);
+            relay->state = 0;
+          }
+        }
+        // Estado 5: Activación por tiempo definido
+        else if (relay->state == 5) {
+          setRelayOutput(i, true);
+          relay->tmr_100ms = relay->time * 10; // Convertir a incrementos de 100ms
+          relay->state = 6; // Pasar al siguiente estado
+        }
+        // Estado 6: Esperando fin de activación
+        else if (relay->state == 6) {
+          if (relay->tmr_100ms > 0) {
+            relay->tmr_100ms--;
+          } else {
+            setRelayOutput(i, false);
+            relay->state = 0;
+          }
+        }
+        // Estado 7: Activación permanente
+        else if (relay->state == 7) {
+          setRelayOutput(i, true);
+          // Este estado permanece hasta que se cambie manualmente
+        }
+        // Otros estados especiales
+        else if (relay->state == 10 || relay->state == 20 || relay->state == 30 || relay->state == 45) {
+          setRelayOutput(i, true);
+          relay->tmr_100ms = relay->state * 10; // Usar el propio estado como tiempo
+          relay->state = 6; // Pasar al estado de espera
+        }
+      }
+    }
+  }
+
+// Continuación de processP_Command
+
+        setMessage(response, MSG_DDMM1_PRESENT_SET, DDMM1_TimePresent);
+      } else {
+        sendNAK();
+        response.success = false;
+        setMessage(response, MSG_NOT_ENOUGH_DATA);
+      }
+      break;
+      
+    case '7':
+      // P7: Configurar tiempo de ausencia DDMM2
+      if (dataLen >= 2) {
+        DDMM2_TimeAbsent = (ascii2hex(data[0]) * 10) + ascii2hex(data[1]);
+        saveDDMMTime(3, DDMM2_TimeAbsent);
+        
+        sendACK();
+        setMessage(response, MSG_DDMM2_ABSENT_SET, DDMM2_TimeAbsent);
+      } else {
+        sendNAK();
+        response.success = false;
+        setMessage(response, MSG_NOT_ENOUGH_DATA);
+      }
+      break;
+      
+    case '8':
+      // P8: Configurar tiempo de presencia DDMM2
+      if (dataLen >= 2) {
+        DDMM2_TimePresent = (ascii2hex(data[0]) * 10) + ascii2hex(data[1]);
+        saveDDMMTime(2, DDMM2_TimePresent);
+        
+        sendACK();
+        setMessage(response, MSG_DDMM2_PRESENT_SET, DDMM2_TimePresent);
+      } else {
+        sendNAK();
+        response.success = false;
+        setMessage(response, MSG_NOT_ENOUGH_DATA);
+      }
+      break;
+      
+    default:
+      sendNAK();
+      response.success = false;
+      setMessage(response, MSG_UNKNOWN_SUBCODE, messageCode('P', subCode));
+      break;
+  }
+  
+  return response;
+}
+
+// Implementación de procesamiento de comandos tipo "R"
+CommandResponse processR_Command(char subCode, const char* data, int dataLen) {
+  CommandResponse response = {true, MSG_NONE, 0, ""};
+  
+  switch (subCode) {
+    case '1':
+    case '2':
+    case '3':
+    case '4':
+    case '5':
+      // R1-R5: Desactivar relé (solo los que maneja el perfil)
+      if (deactivateRelay(subCode - '0')) {
+        sendACK();
+        setMessage(response, MSG_RELAY_OFF, subCode - '0');
+      } else {
+        sendNAK();
+        response.success = false;
+        setMessage(response, MSG_NOT_ALLOWED);
+      }
+      break;
+      
+    case '6':
+      // R6: Indicar playa libre
+      deactivateRelay(2);
+      // Aquí podríamos establecer alguna variable de estado para playa llena
+      sendACK();
+      setMessage(response, MSG_LOT_FREE);
+      break;
+      
+    case '7':
+      // R7: Reiniciar estado lector/scanner
+      resetScannerState();
+      
+      if (RELAY_COUNT > 2) relays[2].state = 1; // Activar relay 3
+      relays[0].tmr_100ms = 10; // Timer 1 segundo
+      relays[0].state = 0;
+      deactivateRelay(1);
+      
+      sendACK();
+      setMessage(response, MSG_READER_RESET);
+      break;
+      
+    default:
+      sendNAK();
+      response.success = false;
+      setMessage(response, MSG_UNKNOWN_SUBCODE, messageCode('R', subCode));
+      break;
+  }
+  
+  return response;
+}
+
+// Implementación de procesamiento de comandos tipo "S"
+CommandResponse processS_Command(char subCode, const char* data, int dataLen) {
+  CommandResponse response = {true, MSG_NONE, 0, ""};
+  
+  switch (subCode) {
+    case '0':
+      // S0: Consultar status
+      sendStatus();
+      setMessage(response, MSG_STATUS_SENT, statusInfo.status);
+      break;
+      
+    case '1':
+    case '2':
+    case '3':
+    case '4':
+    case '5':
+      // S1-S5: Activar relé (solo los que maneja el perfil)
+      if (activateRelay(subCode - '0')) {
+        sendACK();
+        setMessage(response, MSG_RELAY_ON, subCode - '0');
+      } else {
+        sendNAK();
+        response.success = false;
+        setMessage(response, MSG_NOT_ALLOWED);
+      }
+      break;
+      
+    case '6':
+      // S6: Indicar playa llena
+      activateRelay(2);
+      // Aquí podríamos establecer alguna variable de estado para playa llena
+      sendACK();
+      setMessage(response, MSG_LOT_FULL);
+      break;
+      
+    case '7':
+      // S7: Activar barrera (Relé 1 estado 7)
+      relays[0].state = 7;
+      sendACK();
+      setMessage(response, MSG_BARRIER_ON);
+      break;
+      
+    default:
+      sendNAK();
+      response.success = false;
+      setMessage(response, MSG_UNKNOWN_SUBCODE, messageCode('S', subCode));
+      break;
+  }
+  
+  return response;
+}
+
+// Implementación de procesamiento de comandos tipo "T"
+CommandResponse processT_Command(char subCode, const char* data, int dataLen) {
+  CommandResponse response = {true, MSG_NONE, 0, ""};
+  
+  // Las líneas del ticket se guardan en el bloque de configuración
+  char linea[17];
+  
+  switch (subCode) {
+    case '0':
+      // T0: Leer línea 1 del ticket
+      if (!sendCachedReply(REPLY_T0 + 0)) {
+        loadTicketLine(1, linea, sizeof(linea));
+        sendCachedData(REPLY_T0 + 0, "T", "0", linea);
+      }
+      setMessage(response, MSG_TICKET_LINE_SENT, 1);
+      break;
+      
+    case '1':
+      // T1: Leer línea 2 del ticket
+      if (!sendCachedReply(REPLY_T0 + 1)) {
+        loadTicketLine(2, linea, sizeof(linea));
+        sendCachedData(REPLY_T0 + 1, "T", "1", linea);
+      }
+      setMessage(response, MSG_TICKET_LINE_SENT, 2);
+      break;
+      
+    case '2':
+      // T2: Leer línea 3 del ticket
+      if (!sendCachedReply(REPLY_T0 + 2)) {
+        loadTicketLine(3, linea, sizeof(linea));
+        sendCachedData(REPLY_T0 + 2, "T", "2", linea);
+      }
+      setMessage(response, MSG_TICKET_LINE_SENT, 3);
+      break;
+      
+    case '3':
+      // T3: Leer línea 4 del ticket
+      if (!sendCachedReply(REPLY_T0 + 3)) {
+        loadTicketLine(4, linea, sizeof(linea));
+        sendCachedData(REPLY_T0 + 3, "T", "3", linea);
+      }
+      setMessage(response, MSG_TICKET_LINE_SENT, 4);
+      break;
+      
+    case '4':
+      // T4: Grabar línea 1 del ticket
+      if (dataLen >= 16) {
+        // Copiar los datos a la línea 1
+        memcpy(linea, data, 16);
+        linea[16] = '\0';
+        
+        // Guardar en EEPROM
+        saveTicketLine(1, linea);
+        
+        sendACK();
+        setMessage(response, MSG_TICKET_LINE_SAVED, 1);
+      } else {
+        sendNAK();
+        response.success = false;
+        setMessage(response, MSG_NOT_ENOUGH_DATA);
+      }
+      break;
+      
+    case '5':
+      // T5: Grabar línea 2 del ticket
+      if (dataLen >= 16) {
+        // Copiar los datos a la línea 2
+        memcpy(linea, data, 16);
+        linea[16] = '\0';
+        
+        // Guardar en EEPROM
+        saveTicketLine(2, linea);
+        
+        sendACK();
+        setMessage(response, MSG_TICKET_LINE_SAVED, 2);
+      } else {
+        sendNAK();
+        response.success = false;
+        setMessage(response, MSG_NOT_ENOUGH_DATA);
+      }
+      break;
+      
+    case '6':
+      // T6: Grabar línea 3 del ticket
+      if (dataLen >= 16) {
+        // Copiar los datos a la línea 3
+        memcpy(linea, data, 16);
+        linea[16] = '\0';
+        
+        // Guardar en EEPROM
+        saveTicketLine(3, linea);
+        
+        sendACK();
+        setMessage(response, MSG_TICKET_LINE_SAVED, 3);
+      } else {
+        sendNAK();
+        response.success = false;
+        setMessage(response, MSG_NOT_ENOUGH_DATA);
+      }
+      break;
+      
+    case '7':
+      // T7: Grabar línea 4 del ticket
+      if (dataLen >= 16) {
+        // Copiar los datos a la línea 4
+        memcpy(linea, data, 16);
+        linea[16] = '\0';
+        
+        // Guardar en EEPROM
+        saveTicketLine(4, linea);
+        
+        sendACK();
+        setMessage(response, MSG_TICKET_LINE_SAVED, 4);
+      } else {
+        sendNAK();
+        response.success = false;
+        setMessage(response, MSG_NOT_ENOUGH_DATA);
+      }
+      break;
+      
+    case '9':
+      // T9: Imprimir ticket e informar número generado
+      {
+        // Número secuencial (sin acceso a flash salvo al agotar la reserva)
+        uint32_t number = issueTicketNumber();
+        if (number == 0) {
+          // Sin reserva grabada el número podría repetirse tras un corte
+          sendNAK();
+          response.success = false;
+          setMessage(response, MSG_STORAGE_SYNC_FAILED);
+          break;
+        }
+        
+        char ticket[13];
+        sprintf(ticket, "%012lu", (unsigned long)number);
+        
+        // Enviar respuesta
+        sendData("T", "9", ticket);
+        
+        setMessage(response, MSG_TICKET_ISSUED);
+        strcpy(response.data, ticket);
+      }
+      break;
+      
+    default:
+      sendNAK();
+      response.success = false;
+      setMessage(response, MSG_UNKNOWN_SUBCODE, messageCode('T', subCode));
+      break;
+  }
+  
+  return response;
+}
+
+// Implementación de procesamiento de comandos tipo "V"
+CommandResponse processV_Command(char subCode, const char* data, int dataLen) {
+  CommandResponse response = {true, MSG_NONE, 0, ""};
+  
+  switch (subCode) {
+    case '0':
+      // V0: Consultar versión
+      {
+        // Enviar versión del firmware
+        char version[] = "OemProxy v1.0";
+        if (!sendCachedReply(REPLY_V0)) sendCachedData(REPLY_V0, "V", "0", version);
+        
+        setMessage(response, MSG_VERSION_SENT);
+        strcpy(response.data, version);
+      }
+      break;
+      
+    case '1':
+      // V1: Consultar margen de memoria (pilas y heap, en bytes)
+      {
+        char summary[48];
+        formatMemorySummary(summary, sizeof(summary));
+        sendData("V", "1", summary);
+        
+        setMessage(response, MSG_MEMORY_SENT);
+        safeStrCopy(response.data, summary, sizeof(response.data));
+      }
+      break;
+      
+    default:
+      sendNAK();
+      response.success = false;
+      setMessage(response, MSG_UNKNOWN_SUBCODE, messageCode('V', subCode));
+      break;
+  }
+  
+  return response;
+}
+
+// Implementación de procesamiento de comandos tipo "X"
+CommandResponse processX_Command(char subCode, const char* data, int dataLen) {
+  CommandResponse response = {true, MSG_NONE, 0, ""};
+  
+  switch (subCode) {
+    case '0':
+      // X0: Reiniciar dispositivo
+      sendACK();
+      setMessage(response, MSG_RESTARTING);
+      
+      scheduleRestart();
+      break;
+      
+    case '1':
+      // X1: Sincronizar almacenamiento (ACK solo cuando los datos están en flash)
+      if (syncStorage()) {
+        sendACK();
+        setMessage(response, MSG_STORAGE_SYNCED);
+      } else {
+        sendNAK();
+        response.success = false;
+        setMessage(response, MSG_STORAGE_SYNC_FAILED);
+      }
+      break;
+      
+    case '9':
+      // X9: Reiniciar dispositivo (alternativo)
+      sendACK();
+      setMessage(response, MSG_RESTARTING);
+      
+      scheduleRestart();
+      break;
+      
+    default:
+      sendNAK();
+      response.success = false;
+      setMessage(response, MSG_UNKNOWN_SUBCODE, messageCode('X', subCode));
+      break;
+  }
+  
+  return response;
+}
+
+// Implementación de procesamiento de comandos tipo "Z"
+CommandResponse processZ_Command(char subCode, const char* data, int dataLen) {
+  CommandResponse response = {true, MSG_NONE, 0, ""};
+  
+  switch (subCode) {
+    case '0':
+      // Z0: Configurar códigos de barras
+      if (dataLen >= 4) {
+        // Formato: unidad_mil + 3 dígitos
+        char unidadMil = data[0];
+        char counter[4] = {data[1], data[2], data[3], '\0'};
+        
+        // Guardar en EEPROM o variables globales
+        
+        sendACK();
+        setMessage(response, MSG_BARCODE_SET);
+        sprintf(response.data, "%c%s", unidadMil, counter);
+      } else {
+        sendNAK();
+        response.success = false;
+        setMessage(response, MSG_NOT_ENOUGH_DATA);
+      }
+      break;
+      
+    case '1':
+      // Z1: Consultar configuración de códigos de barras
+      {
+        // Deberíamos leer estos valores de EEPROM o variables globales
+        // Por ahora enviamos valores estáticos
+        char config[] = "A123";
+        
+        if (!sendCachedReply(REPLY_Z1)) sendCachedData(REPLY_Z1, "Z", "1", config);
+        setMessage(response, MSG_BARCODE_CONFIG);
+        strcpy(response.data, config);
+      }
+      break;
+      
+    case '9':
+      // Z9: Mostrar configuración
+      {
+        // Aquí deberíamos tener código para mostrar la configuración en el display
+        // Por ahora solo respondemos con ACK
+        
+        sendACK();
+        setMessage(response, MSG_DISPLAY_SHOWN);
+      }
+      break;
+      
+    default:
+      sendNAK();
+      response.success = false;
+      setMessage(response, MSG_UNKNOWN_SUBCODE, messageCode('Z', subCode));
+      break;
+  }
+  
+  return response;
 }
\ No newline at end of file
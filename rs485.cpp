@@ -0,0 +1,71 @@
+#include "rs485.h"
+#include "variables.h"
+#include "utilidades.h"
+
+#ifdef ESP8266
+  HardwareSerial& rs485Serial = Serial;
+#elif defined(ESP32)
+  HardwareSerial& rs485Serial = Serial2;
+#endif
+
+// Silencio que marca el fin de una trama, en µs (10 bits por carácter)
+static uint32_t idleUs = 0;
+
+#ifdef ESP32
+  // Lo activa el driver de la UART (interrupción de timeout de RX)
+  static volatile bool lineIdle = false;
+
+  static void onLineIdle() {
+    lineIdle = true;
+  }
+#else
+  // ESP8266: el driver no avisa la línea ociosa; se detecta porque la
+  // cantidad de bytes pendientes deja de crecer durante idleUs
+  static int lastAvailable = 0;
+  static uint32_t lastChangeUs = 0;
+#endif
+
+void initRS485() {
+  idleUs = (uint32_t)RS485_IDLE_SYMBOLS * 10 * 1000000UL / RS485_BAUDRATE;
+  
+  pinMode(DE_RE_PIN, OUTPUT);
+  setRxMode();
+  
+  #ifdef ESP8266
+    rs485Serial.setRxBufferSize(RS485_RX_BUFFER);
+    rs485Serial.begin(RS485_BAUDRATE, SERIAL_8N1);
+    rs485Serial.swap(); // RX en GPIO13, TX en GPIO15
+  #elif defined(ESP32)
+    rs485Serial.setRxBufferSize(RS485_RX_BUFFER);
+    rs485Serial.begin(RS485_BAUDRATE, SERIAL_8N1, RS485_RX_PIN, RS485_TX_PIN);
+    rs485Serial.setRxTimeout(RS485_IDLE_SYMBOLS);
+    rs485Serial.onReceive(onLineIdle, true);
+  #endif
+}
+
+size_t readRS485Block(uint8_t* block, size_t size) {
+  int available = rs485Serial.available();
+  if (available <= 0) return 0;
+  
+  #ifdef ESP32
+    if (!lineIdle && (size_t)available < size) return 0;
+  #else
+    uint32_t now = micros();
+    if (available != lastAvailable) {
+      lastAvailable = available;
+      lastChangeUs = now;
+    }
+    if (now - lastChangeUs < idleUs && (size_t)available < size) return 0;
+  #endif
+  
+  size_t count = rs485Serial.readBytes(block, min((size_t)available, size));
+  
+  // Si quedó algo de la misma trama se entrega en la próxima llamada
+  #ifdef ESP32
+    lineIdle = rs485Serial.available() > 0;
+  #else
+    lastAvailable = rs485Serial.available();
+  #endif
+  
+  return count;
+}
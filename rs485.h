@@ -0,0 +1,33 @@
+#ifndef RS485_H
+#define RS485_H
+
+#include <Arduino.h>
+#include <HardwareSerial.h>
+
+// Puerto RS485 sobre la UART por hardware
+// La UART recibe por interrupción desde su FIFO a un buffer circular; el fin
+// de trama se detecta por línea ociosa y el bloque completo se entrega de una
+// vez al parser (processIncomingBlock), en lugar de byte por byte.
+// ESP8266: UART0 intercambiada a GPIO13 (RX) / GPIO15 (TX); los logs salen
+// por Serial1 (GPIO2, solo TX).
+// ESP32: UART2 en los pines RS485_RX_PIN / RS485_TX_PIN.
+
+#define RS485_RX_BUFFER     256     // Buffer circular de recepción del driver
+#define RS485_BLOCK_SIZE    128     // Bloque leído de una vez
+#define RS485_IDLE_SYMBOLS  3       // Caracteres de silencio que cierran una trama
+
+#ifdef ESP32
+  #define RS485_RX_PIN      16
+  #define RS485_TX_PIN      17
+#endif
+
+extern HardwareSerial& rs485Serial;
+
+// Configurar la UART, el pin DE/RE y la detección de línea ociosa
+void initRS485();
+
+// Copiar en block lo recibido si la línea quedó ociosa (o el bloque se llenó)
+// Devuelve la cantidad de bytes, 0 si la trama todavía está llegando
+size_t readRS485Block(uint8_t* block, size_t size);
+
+#endif
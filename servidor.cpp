@@ -0,0 +1,725 @@
+#include "servidor.h"
+#include "perfil.h"
+#include "utilidades.h"
+#include "arena.h"
+#include "memoria.h"
+
+// Solo en perfiles con servidor HTTP (perfil.h)
+#if PROFILE_HTTP
+
+#ifdef ESP32
+  #include <lwip/sockets.h>
+#endif
+
+// Espacio reservado al inicio de head para la línea de estado y las
+// cabeceras fijas, que se escriben al terminar el manejador
+#define HTTP_STATUS_RESERVE 160
+
+HttpServer server(HTTP_PORT);
+
+// Escribir sin esperar: devuelve los bytes aceptados (0 si el socket está
+// lleno) o -1 si la conexión se cerró
+int writeSome(WiFiClient& client, const char* data, size_t len) {
+#ifdef ESP8266
+  // Solo lo que entra en el buffer de envío de lwIP, así write() no espera ACKs
+  size_t room = client.availableForWrite();
+  if (room == 0) return client.connected() ? 0 : -1;
+  return client.write((const uint8_t*)data, min(len, room));
+#elif defined(ESP32)
+  int n = lwip_send(client.fd(), data, len, MSG_DONTWAIT);
+  if (n < 0) return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+  return n;
+#endif
+}
+
+// Decodificar %XX y '+' sobre el mismo buffer
+static void urlDecodeInPlace(char* text) {
+  char* out = text;
+  
+  while (*text) {
+    if (*text == '+') {
+      *out++ = ' ';
+      text++;
+    } else if (*text == '%' && isxdigit(text[1]) && isxdigit(text[2])) {
+      *out++ = (ascii2hex(text[1]) << 4) | ascii2hex(text[2]);
+      text += 3;
+    } else {
+      *out++ = *text++;
+    }
+  }
+  
+  *out = '\0';
+}
+
+static HTTPMethod parseMethod(const char* name) {
+  if (strcmp(name, "GET") == 0) return HTTP_GET;
+  if (strcmp(name, "POST") == 0) return HTTP_POST;
+  if (strcmp(name, "PUT") == 0) return HTTP_PUT;
+  if (strcmp(name, "PATCH") == 0) return HTTP_PATCH;
+  if (strcmp(name, "DELETE") == 0) return HTTP_DELETE;
+  if (strcmp(name, "OPTIONS") == 0) return HTTP_OPTIONS;
+  if (strcmp(name, "HEAD") == 0) return HTTP_HEAD;
+  return HTTP_ANY;
+}
+
+static const char* reasonPhrase(int code) {
+  switch (code) {
+    case 200: return "OK";
+    case 204: return "No Content";
+    case 304: return "Not Modified";
+    case 400: return "Bad Request";
+    case 404: return "Not Found";
+    case 405: return "Method Not Allowed";
+    case 413: return "Payload Too Large";
+    case 429: return "Too Many Requests";
+    case 500: return "Internal Server Error";
+    case 503: return "Service Unavailable";
+    default:  return "";
+  }
+}
+
+// Recargar el balde según el tiempo transcurrido y consumir un token
+static bool takeToken(TokenBucket& bucket, uint16_t ratePerMinute, uint8_t burst) {
+  unsigned long now = millis();
+  uint32_t capacity = (uint32_t)burst * 1000;
+  
+  // ratePerMinute tokens cada 60000 ms = ratePerMinute / 60 milésimas por ms
+  // En 64 bits: tras horas sin pedidos el producto no entra en 32
+  uint64_t refill = (uint64_t)(now - bucket.lastRefill) * ratePerMinute / 60;
+  if (refill > 0) {
+    uint64_t tokens = bucket.milliTokens + refill;
+    bucket.milliTokens = tokens < capacity ? (uint32_t)tokens : capacity;
+    bucket.lastRefill = now;
+  }
+  
+  if (bucket.milliTokens < 1000) return false;
+  
+  bucket.milliTokens -= 1000;
+  return true;
+}
+
+static void fillBucket(TokenBucket& bucket, uint8_t burst) {
+  bucket.milliTokens = (uint32_t)burst * 1000;
+  bucket.lastRefill = millis();
+}
+
+HttpServer::HttpServer(uint16_t port)
+  : listener(port), current(NULL), largeOwner(NULL), routeCount(0), notFoundHandler(NULL), notFoundRequests(0),
+    clientRejected(0), deferred(0), headerKeyCount(0) {
+  for (int i = 0; i < HTTP_MAX_CLIENTS; i++) {
+    connections[i].state = HTTP_CONN_LIBRE;
+  }
+  
+  for (int i = 0; i < HTTP_MAX_CLIENT_IPS; i++) {
+    clientLimits[i].ip = 0;
+    clientLimits[i].lastSeen = 0;
+  }
+}
+
+void HttpServer::begin() {
+  listener.begin();
+  listener.setNoDelay(true);
+}
+
+// Atender todas las conexiones sin bloquear (llamar en cada vuelta de loop())
+// Pasado HTTP_LOOP_BUDGET_US no se leen ni despachan más pedidos: quedan en el
+// socket para la próxima vuelta y el control de barreras no espera
+void HttpServer::handleClient() {
+  unsigned long start = micros();
+  acceptClients();
+  
+  for (int i = 0; i < HTTP_MAX_CLIENTS; i++) {
+    HttpConnection& conn = connections[i];
+    if (conn.state == HTTP_CONN_LIBRE) continue;
+    
+    if (conn.state == HTTP_CONN_RECIBIENDO) {
+      if (micros() - start < HTTP_LOOP_BUDGET_US) {
+        receive(conn);
+      } else if (conn.client.available() > 0) {
+        deferred++;
+        conn.lastActivity = millis(); // La espera es nuestra, no del cliente
+      }
+    }
+    if (conn.state == HTTP_CONN_ENVIANDO) transmit(conn);
+    
+    // Cliente que dejó de leer o de escribir
+    if (conn.state != HTTP_CONN_LIBRE && millis() - conn.lastActivity > HTTP_CLIENT_TIMEOUT_MS) {
+      close(conn);
+    }
+  }
+}
+
+void HttpServer::on(const char* uri, HTTPMethod method, THandlerFunction handler) {
+  on(uri, method, handler, 0, 0);
+}
+
+// Ruta con límite de pedidos (balde de tokens compartido por todos los clientes)
+void HttpServer::on(const char* uri, HTTPMethod method, THandlerFunction handler, uint16_t ratePerMinute, uint8_t burst) {
+  if (routeCount >= HTTP_MAX_ROUTES) {
+    logError("Tabla de rutas HTTP llena");
+    return;
+  }
+  
+  Route& route = routes[routeCount];
+  route.uri = uri;
+  route.method = method;
+  route.handler = handler;
+  route.requests = 0;
+  route.ratePerMinute = ratePerMinute;
+  route.burst = burst;
+  route.rejected = 0;
+  fillBucket(route.bucket, burst);
+  routeCount++;
+}
+
+void HttpServer::onNotFound(THandlerFunction handler) {
+  notFoundHandler = handler;
+}
+
+// Solo se conservan las cabeceras pedidas (los nombres deben ser estáticos)
+void HttpServer::collectHeaders(const char* keys[], size_t count) {
+  headerKeyCount = min(count, (size_t)HTTP_MAX_HEADERS);
+  for (uint8_t i = 0; i < headerKeyCount; i++) {
+    headerKeys[i] = keys[i];
+  }
+}
+
+// Aceptar conexiones nuevas mientras haya lugar; las demás esperan en la cola
+// de lwIP hasta que se libere una conexión
+void HttpServer::acceptClients() {
+  for (int i = 0; i < HTTP_MAX_CLIENTS; i++) {
+    HttpConnection& conn = connections[i];
+    if (conn.state != HTTP_CONN_LIBRE) continue;
+    
+    if (!listener.hasClient()) return;
+    
+    conn.client = listener.available();
+    if (!conn.client) return;
+    
+    conn.client.setNoDelay(true);
+    conn.state = HTTP_CONN_RECIBIENDO;
+    conn.lastActivity = millis();
+    conn.requestLength = 0;
+    conn.request[0] = '\0';
+    conn.content = NULL;
+    conn.contentLength = 0;
+  }
+}
+
+// Leer lo que haya disponible; despachar cuando la petición está completa
+void HttpServer::receive(HttpConnection& conn) {
+  int available = conn.client.available();
+  
+  if (available <= 0) {
+    if (!conn.client.connected()) close(conn);
+    return;
+  }
+  
+  size_t room = HTTP_REQUEST_BUFFER - conn.requestLength;
+  if (room == 0) {
+    sendError(conn, 413, "Petición demasiado grande");
+    return;
+  }
+  
+  int n = conn.client.read((uint8_t*)conn.request + conn.requestLength, min((size_t)available, room));
+  if (n <= 0) return;
+  
+  conn.requestLength += n;
+  conn.request[conn.requestLength] = '\0';
+  conn.lastActivity = millis();
+  
+  // Cabeceras completas: analizarlas una sola vez
+  if (conn.content == NULL) {
+    char* end = strstr(conn.request, "\r\n\r\n");
+    if (end == NULL) return;
+    
+    conn.content = end + 4;
+    if (!parseRequest(conn)) {
+      sendError(conn, 400, "Petición inválida");
+      return;
+    }
+  }
+  
+  size_t headerLength = conn.content - conn.request;
+  if (conn.requestLength - headerLength < conn.contentLength) {
+    if (headerLength + conn.contentLength > HTTP_REQUEST_BUFFER) {
+      sendError(conn, 413, "Petición demasiado grande");
+    }
+    return;
+  }
+  
+  conn.content[conn.contentLength] = '\0';
+  dispatch(conn);
+}
+
+// Analizar línea de petición y cabeceras sobre el mismo buffer
+bool HttpServer::parseRequest(HttpConnection& conn) {
+  conn.argCount = 0;
+  for (int i = 0; i < HTTP_MAX_HEADERS; i++) conn.headerValues[i] = NULL;
+  conn.contentLength = 0;
+  conn.isForm = false;
+  
+  // Línea de petición: MÉTODO URI VERSIÓN
+  char* line = conn.request;
+  char* next = strstr(line, "\r\n");
+  if (next == NULL) return false;
+  *next = '\0';
+  
+  char* uri = strchr(line, ' ');
+  if (uri == NULL) return false;
+  *uri++ = '\0';
+  
+  char* version = strchr(uri, ' ');
+  if (version == NULL) return false;
+  *version = '\0';
+  
+  conn.method = parseMethod(line);
+  conn.uri = uri;
+  
+  // Cabeceras hasta la línea vacía
+  line = next + 2;
+  while (line < conn.content - 2) {
+    next = strstr(line, "\r\n");
+    if (next == NULL) return false;
+    *next = '\0';
+    
+    char* value = strchr(line, ':');
+    if (value != NULL) {
+      *value++ = '\0';
+      while (*value == ' ') value++;
+      
+      if (strcasecmp(line, "Content-Length") == 0) {
+        conn.contentLength = strtoul(value, NULL, 10);
+      } else if (strcasecmp(line, "Content-Type") == 0) {
+        conn.isForm = strncmp(value, "application/x-www-form-urlencoded", 33) == 0;
+      }
+      
+      for (uint8_t i = 0; i < headerKeyCount; i++) {
+        if (strcasecmp(line, headerKeys[i]) == 0) conn.headerValues[i] = value;
+      }
+    }
+    
+    line = next + 2;
+  }
+  
+  // Argumentos de la query
+  char* query = strchr(conn.uri, '?');
+  if (query != NULL) {
+    *query++ = '\0';
+    parseArgs(conn, query);
+  }
+  
+  return true;
+}
+
+// Separar pares nombre=valor de una query o formulario
+void HttpServer::parseArgs(HttpConnection& conn, char* query) {
+  while (query != NULL && *query != '\0' && conn.argCount < HTTP_MAX_ARGS) {
+    char* next = strchr(query, '&');
+    if (next != NULL) *next++ = '\0';
+    
+    char* value = strchr(query, '=');
+    if (value != NULL) {
+      *value++ = '\0';
+    } else {
+      value = query + strlen(query);
+    }
+    
+    urlDecodeInPlace(query);
+    urlDecodeInPlace(value);
+    conn.argNames[conn.argCount] = query;
+    conn.argValues[conn.argCount] = value;
+    conn.argCount++;
+    
+    query = next;
+  }
+}
+
+// Ejecutar el manejador de la ruta y dejar la respuesta lista para enviar
+void HttpServer::dispatch(HttpConnection& conn) {
+  // Cuerpo: formulario como argumentos, cualquier otro como "plain"
+  if (conn.contentLength > 0) {
+    if (conn.isForm) {
+      parseArgs(conn, conn.content);
+    } else if (conn.argCount < HTTP_MAX_ARGS) {
+      conn.argNames[conn.argCount] = "plain";
+      conn.argValues[conn.argCount] = conn.content;
+      conn.argCount++;
+    }
+  }
+  
+  conn.code = 200;
+  conn.contentType[0] = '\0';
+  conn.headLength = HTTP_STATUS_RESERVE;
+  conn.bodyData = conn.body;
+  conn.bodySize = sizeof(conn.body);
+  conn.bodyLength = 0;
+  conn.flashBody = NULL;
+  conn.flashLength = 0;
+  conn.overflow = false;
+  conn.bodyOverflow = false;
+  
+  // Límite por IP, antes de buscar la ruta
+  bool limited = !admitClient(conn);
+  if (limited) clientRejected++;
+  
+  THandlerFunction handler = NULL;
+  for (uint8_t i = 0; i < routeCount && !limited; i++) {
+    Route& route = routes[i];
+    if (strcmp(route.uri, conn.uri) == 0 &&
+        (route.method == HTTP_ANY || route.method == conn.method)) {
+      route.requests++;
+      
+      // Límite propio de la ruta
+      if (route.ratePerMinute > 0 && !takeToken(route.bucket, route.ratePerMinute, route.burst)) {
+        route.rejected++;
+        limited = true;
+      }
+      
+      handler = route.handler;
+      break;
+    }
+  }
+  
+  if (handler == NULL && !limited) {
+    handler = notFoundHandler;
+    notFoundRequests++;
+  }
+  
+  current = &conn;
+  if (limited) {
+    sendHeader("Retry-After", "1");
+    send(429, "text/plain", "Demasiados pedidos");
+  } else if (handler != NULL) {
+    handler();
+  } else {
+    send(404, "text/plain", "Not found");
+  }
+  current = NULL;
+  
+  // La respuesta ya está copiada en la conexión: liberar el texto del pedido
+  sampleHeap();
+  requestArena.reset();
+  
+  if (conn.overflow) {
+    sendError(conn, 500, "Cabeceras de respuesta demasiado grandes");
+    return;
+  }
+  
+  if (conn.bodyOverflow) {
+    sendError(conn, 500, "Respuesta demasiado grande");
+    return;
+  }
+  
+  finishResponse(conn);
+}
+
+// Balde de tokens de la IP del cliente; una IP nueva reemplaza a la que
+// lleva más tiempo sin pedir
+bool HttpServer::admitClient(HttpConnection& conn) {
+  uint32_t ip = (uint32_t)conn.client.remoteIP();
+  ClientLimit* slot = &clientLimits[0];
+  
+  for (int i = 0; i < HTTP_MAX_CLIENT_IPS; i++) {
+    if (clientLimits[i].ip == ip) {
+      slot = &clientLimits[i];
+      break;
+    }
+    if (clientLimits[i].lastSeen < slot->lastSeen) slot = &clientLimits[i];
+  }
+  
+  if (slot->ip != ip) {
+    slot->ip = ip;
+    fillBucket(slot->bucket, HTTP_IP_BURST);
+  }
+  
+  slot->lastSeen = millis();
+  return takeToken(slot->bucket, HTTP_IP_RATE_PER_MIN, HTTP_IP_BURST);
+}
+
+// Escribir línea de estado y cabeceras fijas delante de las agregadas con
+// sendHeader(), en el espacio reservado al comienzo de head
+void HttpServer::finishHead(HttpConnection& conn) {
+  char prefix[HTTP_STATUS_RESERVE];
+  int n = snprintf(prefix, sizeof(prefix), "HTTP/1.1 %d %s\r\n", conn.code, reasonPhrase(conn.code));
+  
+  if (conn.contentType[0] != '\0') {
+    n += snprintf(prefix + n, sizeof(prefix) - n, "Content-Type: %s\r\n", conn.contentType);
+  }
+  
+  if (conn.code != 204 && conn.code != 304) {
+    n += snprintf(prefix + n, sizeof(prefix) - n, "Content-Length: %u\r\n", (unsigned)(conn.bodyLength + conn.flashLength));
+  }
+  
+  n += snprintf(prefix + n, sizeof(prefix) - n, "Connection: close\r\n");
+  n = min(n, (int)sizeof(prefix) - 1);
+  
+  size_t extra = conn.headLength - HTTP_STATUS_RESERVE;
+  memmove(conn.head + n, conn.head + HTTP_STATUS_RESERVE, extra);
+  memcpy(conn.head, prefix, n);
+  conn.headLength = n + extra;
+  
+  conn.head[conn.headLength++] = '\r';
+  conn.head[conn.headLength++] = '\n';
+}
+
+// Respuesta completa en los buffers: enviarla en las próximas vueltas
+void HttpServer::finishResponse(HttpConnection& conn) {
+  finishHead(conn);
+  conn.sent = 0;
+  conn.state = HTTP_CONN_ENVIANDO;
+}
+
+// Pasar el cuerpo de la conexión al buffer grande, si está libre
+bool HttpServer::takeLargeBody(HttpConnection& conn) {
+  if (largeOwner == &conn) return true;
+  if (largeOwner != NULL) return false;
+  
+  largeOwner = &conn;
+  memcpy(largeBody, conn.body, conn.bodyLength);
+  conn.bodyData = largeBody;
+  conn.bodySize = sizeof(largeBody);
+  return true;
+}
+
+void HttpServer::releaseLargeBody(HttpConnection& conn) {
+  if (largeOwner != &conn) return;
+  
+  largeOwner = NULL;
+  conn.bodyData = conn.body;
+  conn.bodySize = sizeof(conn.body);
+  conn.bodyLength = 0;
+}
+
+// Respuesta de error generada por el propio servidor
+void HttpServer::sendError(HttpConnection& conn, int code, const char* message) {
+  releaseLargeBody(conn);
+  
+  conn.code = code;
+  strcpy(conn.contentType, "text/plain");
+  conn.headLength = HTTP_STATUS_RESERVE;
+  conn.bodyData = conn.body;
+  conn.bodySize = sizeof(conn.body);
+  conn.bodyLength = min(strlen(message), sizeof(conn.body));
+  memcpy(conn.body, message, conn.bodyLength);
+  conn.flashBody = NULL;
+  conn.flashLength = 0;
+  conn.overflow = false;
+  conn.bodyOverflow = false;
+  
+  finishResponse(conn);
+}
+
+// Enviar lo que el socket acepte; cerrar cuando no queda nada pendiente
+void HttpServer::transmit(HttpConnection& conn) {
+  size_t memoryTotal = conn.headLength + conn.bodyLength;
+  size_t total = memoryTotal + conn.flashLength;
+  
+  while (conn.sent < total) {
+    const char* data;
+    size_t len;
+    
+    if (conn.sent < conn.headLength) {
+      data = conn.head + conn.sent;
+      len = conn.headLength - conn.sent;
+    } else if (conn.sent < memoryTotal) {
+      data = conn.bodyData + (conn.sent - conn.headLength);
+      len = memoryTotal - conn.sent;
+    } else {
+      // Cuerpo en flash: copiar un tramo al buffer body de la conexión,
+      // libre porque el cuerpo en memoria ya se envió
+      size_t offset = conn.sent - memoryTotal;
+      len = min(conn.flashLength - offset, sizeof(conn.body));
+      memcpy_P(conn.body, conn.flashBody + offset, len);
+      data = conn.body;
+    }
+    
+    int n = writeSome(conn.client, data, len);
+    if (n < 0) {
+      close(conn);
+      return;
+    }
+    if (n == 0) return; // Socket lleno: seguir en la próxima vuelta
+    
+    conn.sent += n;
+    conn.lastActivity = millis();
+  }
+  
+  close(conn);
+}
+
+void HttpServer::close(HttpConnection& conn) {
+  releaseLargeBody(conn);
+  conn.client.stop();
+  conn.state = HTTP_CONN_LIBRE;
+}
+
+// Petición en curso
+const char* HttpServer::uri() {
+  return current != NULL ? current->uri : "";
+}
+
+HTTPMethod HttpServer::method() {
+  return current != NULL ? current->method : HTTP_ANY;
+}
+
+int HttpServer::args() {
+  return current != NULL ? current->argCount : 0;
+}
+
+const char* HttpServer::arg(const char* name) {
+  if (current == NULL) return "";
+  
+  for (uint8_t i = 0; i < current->argCount; i++) {
+    if (strcmp(current->argNames[i], name) == 0) return current->argValues[i];
+  }
+  
+  return "";
+}
+
+const char* HttpServer::arg(int i) {
+  if (current == NULL || i < 0 || i >= current->argCount) return "";
+  return current->argValues[i];
+}
+
+const char* HttpServer::argName(int i) {
+  if (current == NULL || i < 0 || i >= current->argCount) return "";
+  return current->argNames[i];
+}
+
+bool HttpServer::hasArg(const char* name) {
+  if (current == NULL) return false;
+  
+  for (uint8_t i = 0; i < current->argCount; i++) {
+    if (strcmp(current->argNames[i], name) == 0) return true;
+  }
+  
+  return false;
+}
+
+const char* HttpServer::header(const char* name) {
+  if (current == NULL) return "";
+  
+  for (uint8_t i = 0; i < headerKeyCount; i++) {
+    if (strcasecmp(headerKeys[i], name) == 0 && current->headerValues[i] != NULL) {
+      return current->headerValues[i];
+    }
+  }
+  
+  return "";
+}
+
+bool HttpServer::hasHeader(const char* name) {
+  if (current == NULL) return false;
+  
+  for (uint8_t i = 0; i < headerKeyCount; i++) {
+    if (strcasecmp(headerKeys[i], name) == 0) return current->headerValues[i] != NULL;
+  }
+  
+  return false;
+}
+
+IPAddress HttpServer::remoteIP() {
+  return current != NULL ? current->client.remoteIP() : IPAddress();
+}
+
+// Respuesta en curso
+// Content-Length se calcula al terminar el manejador con el cuerpo completo,
+// así que el valor pedido no hace falta
+void HttpServer::setContentLength(size_t length) {
+  (void)length;
+}
+
+void HttpServer::sendHeader(const char* name, const char* value) {
+  if (current == NULL) return;
+  
+  size_t len = strlen(name) + strlen(value) + 4;
+  if (current->headLength + len + 2 > sizeof(current->head)) {
+    current->overflow = true;
+    return;
+  }
+  
+  current->headLength += sprintf(current->head + current->headLength, "%s: %s\r\n", name, value);
+}
+
+void HttpServer::send(int code, const char* contentType, const char* content) {
+  if (current == NULL) return;
+  
+  current->code = code;
+  if (contentType != NULL) {
+    strncpy(current->contentType, contentType, sizeof(current->contentType) - 1);
+    current->contentType[sizeof(current->contentType) - 1] = '\0';
+  }
+  
+  sendContent(content);
+}
+
+// Cuerpo que queda en flash y se envía directamente desde ahí
+void HttpServer::send_P(int code, const char* contentType, PGM_P content, size_t length) {
+  if (current == NULL) return;
+  
+  send(code, contentType, "");
+  current->flashBody = content;
+  current->flashLength = length;
+}
+
+// Copiar al cuerpo; si no entra en el de la conexión se pasa al buffer grande
+// y si tampoco entra ahí (o está ocupado) la respuesta termina en un 500
+void HttpServer::sendContent(const char* content, size_t length) {
+  if (current == NULL) return;
+  
+  HttpConnection& conn = *current;
+  if (conn.bodyOverflow) return;
+  
+  if (conn.bodyLength + length > conn.bodySize &&
+      (!takeLargeBody(conn) || conn.bodyLength + length > conn.bodySize)) {
+    conn.bodyOverflow = true;
+    return;
+  }
+  
+  memcpy(conn.bodyData + conn.bodyLength, content, length);
+  conn.bodyLength += length;
+}
+
+void HttpServer::sendContent(const char* content) {
+  if (content != NULL) sendContent(content, strlen(content));
+}
+
+bool HttpServer::reserveLargeBody() {
+  return current != NULL && takeLargeBody(*current);
+}
+
+// Estadísticas para /metrics
+uint8_t HttpServer::getRouteCount() {
+  return routeCount;
+}
+
+const char* HttpServer::getRouteUri(uint8_t i) {
+  return i < routeCount ? routes[i].uri : "";
+}
+
+HTTPMethod HttpServer::getRouteMethod(uint8_t i) {
+  return i < routeCount ? routes[i].method : HTTP_ANY;
+}
+
+uint32_t HttpServer::getRouteRequests(uint8_t i) {
+  return i < routeCount ? routes[i].requests : 0;
+}
+
+uint32_t HttpServer::getNotFoundRequests() {
+  return notFoundRequests;
+}
+
+uint32_t HttpServer::getRouteRejected(uint8_t i) {
+  return i < routeCount ? routes[i].rejected : 0;
+}
+
+uint32_t HttpServer::getClientRejected() {
+  return clientRejected;
+}
+
+uint32_t HttpServer::getDeferred() {
+  return deferred;
+}
+
+#endif
@@ -0,0 +1,201 @@
+#ifndef SERVIDOR_H
+#define SERVIDOR_H
+
+#include <Arduino.h>
+
+#ifdef ESP8266
+  #include <ESP8266WiFi.h>
+#elif defined(ESP32)
+  #include <WiFi.h>
+#endif
+
+// Servidor HTTP no bloqueante
+// Atiende varias conexiones a la vez desde loop(): cada llamada a handleClient()
+// lee y escribe solo lo que el socket acepta sin esperar, de modo que un
+// cliente lento nunca retiene el lazo principal (RS485, relés).
+// El manejador arma la respuesta entera en memoria y vuelve enseguida: en el
+// buffer de la conexión, o si no entra en un buffer grande compartido por
+// todas (/metrics, /api/commands), que se libera al cerrar la conexión
+
+// Parámetros del servidor
+#define HTTP_PORT 80
+#define HTTP_MAX_CLIENTS 3           // Conexiones simultáneas
+#define HTTP_MAX_ROUTES 16           // Rutas registradas con on()
+#define HTTP_MAX_ARGS 8              // Argumentos de query/formulario por petición
+#define HTTP_MAX_HEADERS 4           // Cabeceras conservadas con collectHeaders()
+#define HTTP_REQUEST_BUFFER 1024     // Petición completa (cabeceras + cuerpo)
+#define HTTP_HEADER_BUFFER 384       // Línea de estado + cabeceras de respuesta
+#define HTTP_RESPONSE_BUFFER 1024    // Cuerpo de cada conexión
+#define HTTP_LARGE_RESPONSE_BUFFER 8192 // Cuerpo largo compartido (/metrics, lote completo de /api/commands)
+#define HTTP_CLIENT_TIMEOUT_MS 5000  // Inactividad máxima de una conexión
+
+// Control de admisión
+#define HTTP_LOOP_BUDGET_US 4000     // Tiempo máximo despachando pedidos por vuelta de loop()
+#define HTTP_MAX_CLIENT_IPS 8        // IPs con límite propio (se reemplaza la menos reciente)
+#define HTTP_IP_RATE_PER_MIN 300     // Pedidos por minuto por IP
+#define HTTP_IP_BURST 20             // Ráfaga máxima por IP
+
+#define CONTENT_LENGTH_UNKNOWN ((size_t) -1)
+
+// Métodos HTTP (mismos nombres que ESP8266WebServer)
+enum HTTPMethod { HTTP_ANY, HTTP_GET, HTTP_HEAD, HTTP_POST, HTTP_PUT, HTTP_PATCH, HTTP_DELETE, HTTP_OPTIONS };
+
+// Estados de una conexión
+#define HTTP_CONN_LIBRE 0
+#define HTTP_CONN_RECIBIENDO 1
+#define HTTP_CONN_ENVIANDO 2
+
+// Balde de tokens (en milésimas de token para no usar punto flotante)
+struct TokenBucket {
+  uint32_t milliTokens;
+  unsigned long lastRefill;
+};
+
+// Conexión con sus buffers de tamaño fijo
+struct HttpConnection {
+  WiFiClient client;
+  uint8_t state;
+  unsigned long lastActivity;
+  
+  // Petición (se analiza en el mismo buffer)
+  char request[HTTP_REQUEST_BUFFER + 1];
+  size_t requestLength;
+  HTTPMethod method;
+  char* uri;
+  char* content;
+  size_t contentLength;
+  bool isForm;                       // Cuerpo application/x-www-form-urlencoded
+  const char* argNames[HTTP_MAX_ARGS];
+  const char* argValues[HTTP_MAX_ARGS];
+  uint8_t argCount;
+  const char* headerValues[HTTP_MAX_HEADERS];
+  
+  // Respuesta
+  int code;
+  char contentType[32];
+  char head[HTTP_HEADER_BUFFER];
+  size_t headLength;
+  char body[HTTP_RESPONSE_BUFFER];
+  char* bodyData;                    // body o el buffer grande del servidor
+  size_t bodySize;
+  size_t bodyLength;
+  PGM_P flashBody;                   // Cuerpo en flash (send_P), en lugar de body
+  size_t flashLength;
+  size_t sent;                       // Bytes ya enviados de head + body
+  bool overflow;                     // Las cabeceras no entraron en head
+  bool bodyOverflow;                 // El cuerpo no entró en ningún buffer
+};
+
+// Servidor con la misma interfaz que ESP8266WebServer/WebServer para los
+// manejadores: on(), arg(), send(), sendContent()... La respuesta se envía
+// después de que vuelve el manejador, sin bloquearlo; la que no entra en el
+// buffer de la conexión usa el buffer grande, si está libre.
+// Los argumentos y cabeceras se devuelven como punteros al buffer de la
+// petición (válidos mientras corre el manejador), sin copias en String; el
+// texto que arma el manejador va en la arena del pedido (arena.h)
+class HttpServer {
+  public:
+    typedef void (*THandlerFunction)();
+    
+    HttpServer(uint16_t port);
+    
+    void begin();
+    void handleClient();
+    
+    // Rutas
+    void on(const char* uri, HTTPMethod method, THandlerFunction handler);
+    void on(const char* uri, HTTPMethod method, THandlerFunction handler, uint16_t ratePerMinute, uint8_t burst);
+    void onNotFound(THandlerFunction handler);
+    void collectHeaders(const char* headerKeys[], size_t headerKeysCount);
+    
+    // Petición en curso
+    const char* uri();
+    HTTPMethod method();
+    int args();
+    const char* arg(const char* name);     // "" si no está
+    const char* arg(int i);
+    const char* argName(int i);
+    bool hasArg(const char* name);
+    const char* header(const char* name);  // "" si no está
+    bool hasHeader(const char* name);
+    IPAddress remoteIP();
+    
+    // Respuesta en curso
+    void setContentLength(size_t length);
+    void sendHeader(const char* name, const char* value);
+    void send(int code, const char* contentType = NULL, const char* content = "");
+    void send_P(int code, const char* contentType, PGM_P content, size_t length);
+    void sendContent(const char* content, size_t length);
+    void sendContent(const char* content);
+    
+    // Tomar el buffer grande para la respuesta en curso antes de armarla
+    // (false si lo usa otra conexión: responder 503 sin ejecutar nada)
+    bool reserveLargeBody();
+    
+    // Estadísticas para /metrics
+    uint8_t getRouteCount();
+    const char* getRouteUri(uint8_t i);
+    HTTPMethod getRouteMethod(uint8_t i);
+    uint32_t getRouteRequests(uint8_t i);
+    uint32_t getNotFoundRequests();
+    uint32_t getRouteRejected(uint8_t i);
+    uint32_t getClientRejected();
+    uint32_t getDeferred();
+    
+  private:
+    struct Route {
+      const char* uri;
+      HTTPMethod method;
+      THandlerFunction handler;
+      uint32_t requests;
+      uint16_t ratePerMinute;        // 0 = sin límite
+      uint8_t burst;
+      TokenBucket bucket;
+      uint32_t rejected;
+    };
+    
+    struct ClientLimit {
+      uint32_t ip;
+      unsigned long lastSeen;
+      TokenBucket bucket;
+    };
+    
+    void acceptClients();
+    void receive(HttpConnection& conn);
+    void transmit(HttpConnection& conn);
+    void close(HttpConnection& conn);
+    bool admitClient(HttpConnection& conn);
+    bool parseRequest(HttpConnection& conn);
+    void parseArgs(HttpConnection& conn, char* query);
+    void dispatch(HttpConnection& conn);
+    void finishHead(HttpConnection& conn);
+    void finishResponse(HttpConnection& conn);
+    bool takeLargeBody(HttpConnection& conn);
+    void releaseLargeBody(HttpConnection& conn);
+    void sendError(HttpConnection& conn, int code, const char* message);
+    
+    WiFiServer listener;
+    HttpConnection connections[HTTP_MAX_CLIENTS];
+    HttpConnection* current;         // Conexión cuyo manejador se está ejecutando
+    char largeBody[HTTP_LARGE_RESPONSE_BUFFER];
+    HttpConnection* largeOwner;      // Conexión que usa largeBody (NULL si está libre)
+    
+    Route routes[HTTP_MAX_ROUTES];
+    uint8_t routeCount;
+    THandlerFunction notFoundHandler;
+    uint32_t notFoundRequests;
+    
+    ClientLimit clientLimits[HTTP_MAX_CLIENT_IPS];
+    uint32_t clientRejected;           // Pedidos rechazados por límite de IP
+    uint32_t deferred;                 // Pedidos postergados por el presupuesto de loop()
+    
+    const char* headerKeys[HTTP_MAX_HEADERS];
+    uint8_t headerKeyCount;
+};
+
+extern HttpServer server;
+
+// Escritura sin bloqueo sobre un socket (también la usa transporte_tcp.cpp)
+int writeSome(WiFiClient& client, const char* data, size_t len);
+
+#endif
@@ -0,0 +1,339 @@
+#include "tareas.h"
+#include "protocolo.h"
+#include "utilidades.h"
+#include "almacenamiento.h"
+#include "variables.h"
+#include "web.h"
+#include "servidor.h"
+#include "metricas.h"
+#include "planificador.h"
+#include "transporte_tcp.h"
+#include "pasarela.h"
+#include "memoria.h"
+#include "mensajes.h"
+
+#include "rs485.h"
+
+#ifdef ESP32
+  #include <freertos/FreeRTOS.h>
+  #include <freertos/task.h>
+#endif
+
+// Colas entre la tarea web (productora de comandos) y la de protocolo
+static SpscRing<QueuedCommand, TASK_QUEUE_SIZE> commandQueue;
+static SpscRing<QueuedReply, TASK_QUEUE_SIZE> replyQueue;
+static Mailbox<StatusSnapshot> snapshotMailbox;
+
+static bool tasksRunning = false;
+static uint32_t nextCommandId = 1;           // Lo usa solo la tarea web
+
+// Comando que la tarea web sigue esperando (0: ninguno). Quien lo pasa a 0
+// primero decide: la tarea de protocolo antes de ejecutarlo, o la web al
+// vencer la espera, y entonces el comando se descarta sin ejecutarse
+static uint32_t awaitedCommand = 0;
+
+// Lotes terminados del lado web cuya transacción falta cerrar
+static uint8_t batchesToCommit = 0;
+
+static bool claimCommand(uint32_t id) {
+  uint32_t expected = id;
+  return __atomic_compare_exchange_n(&awaitedCommand, &expected, 0, false,
+                                     __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+}
+
+// Estado ya publicado (lo usa solo la tarea de protocolo)
+static uint32_t publishedVersion = 0;
+static uint32_t publishedConfigVersion = 0;
+static uint8_t publishedRelays[RELAY_COUNT];
+static bool publishedOnce = false;
+
+// Copiar el estado actual (solo desde el núcleo que lo modifica)
+static void takeSnapshot(StatusSnapshot& snapshot) {
+  snapshot.version = statusVersion;
+  snapshot.status = statusInfo.status;
+  memcpy(snapshot.statusHex, statusInfo.statusHex, sizeof(snapshot.statusHex));
+  memcpy(snapshot.rfidData, statusInfo.rfidData, sizeof(snapshot.rfidData));
+  for (int i = 0; i < RELAY_COUNT; i++) {
+    snapshot.relayState[i] = relays[i].state;
+    snapshot.relayTime[i] = relays[i].time;
+  }
+  snapshot.configVersion = configVersion;
+  snapshot.config = config;
+}
+
+// Publicar una copia si cambió el status, la configuración o el estado de algún relé
+static void publishSnapshot() {
+  bool changed = !publishedOnce || statusVersion != publishedVersion || configVersion != publishedConfigVersion;
+  for (int i = 0; i < RELAY_COUNT && !changed; i++) {
+    changed = relays[i].state != publishedRelays[i];
+  }
+  if (!changed) return;
+  
+  StatusSnapshot snapshot;
+  takeSnapshot(snapshot);
+  snapshotMailbox.publish(snapshot);
+  
+  publishedVersion = snapshot.version;
+  publishedConfigVersion = snapshot.configVersion;
+  memcpy(publishedRelays, snapshot.relayState, sizeof(publishedRelays));
+  publishedOnce = true;
+}
+
+// Ejecutar un comando capturando su respuesta en un buffer
+static CommandResponse executeCaptured(const char* command, char* reply, size_t replySize) {
+  BufferPrint out(reply, replySize - 1);
+  CommandResponse response = executeCommand(command, out);
+  reply[out.written()] = '\0';
+  return response;
+}
+
+// Bloque recibido del bus todavía sin procesar
+static uint8_t rxBlock[RS485_BLOCK_SIZE];
+static size_t rxLength = 0;
+static size_t rxPosition = 0;
+
+// Recepción: pasar al parser el bloque de la última trama (línea ociosa)
+// Si el bloque trae más de una trama, el resto espera al próximo despacho
+static void rxTask() {
+  if (isCommandComplete()) return;
+  
+  if (rxPosition >= rxLength) {
+    rxLength = readRS485Block(rxBlock, sizeof(rxBlock));
+    rxPosition = 0;
+  }
+  
+  if (rxPosition < rxLength) {
+    rxPosition += processIncomingBlock(rxBlock + rxPosition, rxLength - rxPosition);
+  }
+}
+
+// Despacho: la trama recibida y los comandos llegados por la API
+static void dispatchTask() {
+  if (isCommandComplete()) {
+    // La respuesta de otro equipo a la pasarela no es un comando propio
+    #if PROFILE_GATEWAY
+      if (!gatewayTakeFrame(getCommand())) processCommand(getCommand());
+    #else
+      processCommand(getCommand());
+    #endif
+    clearCommandBuffer();
+  }
+  
+  QueuedCommand command;
+  while (commandQueue.pop(command)) {
+    // Vencido: la tarea web ya respondió que no se ejecutó
+    if (!claimCommand(command.id)) continue;
+    
+    QueuedReply reply;
+    reply.id = command.id;
+    if (command.isConfig) {
+      reply.response = applyConfigUpdate(command.update);
+      reply.reply[0] = '\0';
+    } else {
+      reply.response = executeCaptured(command.command, reply.reply, sizeof(reply.reply));
+    }
+    
+    // La web espera un comando a la vez y descarta las respuestas viejas:
+    // la cola no llega a llenarse
+    replyQueue.push(reply);
+  }
+  
+  // Aquí ya terminó cualquier comando de los lotes cerrados por la web
+  uint8_t batches = __atomic_exchange_n(&batchesToCommit, 0, __ATOMIC_ACQ_REL);
+  while (batches-- > 0) commitStorageTransaction();
+}
+
+// Tareas de cada lado: nombre, función, período y presupuesto (µs)
+static SchedulerTask protocolTasks[] = {
+  SCHEDULER_TASK("rx", rxTask, 0, 200),
+  SCHEDULER_TASK("dispatch", dispatchTask, 0, 2000),
+  #if PROFILE_GATEWAY
+    SCHEDULER_TASK("gateway", gatewayLoop, 0, 2000),
+  #endif
+  SCHEDULER_TASK("relays", updateRelays, RELAY_TICK_MS * 1000UL, 200),
+  SCHEDULER_TASK("storage", storageLoop, STORAGE_POLL_MS * 1000UL, 30000),
+  SCHEDULER_TASK("status", publishSnapshot, 0, 100),
+  SCHEDULER_TASK("restart", restartLoop, RELAY_TICK_MS * 1000UL, 100),
+};
+
+static SchedulerTask webTasks[] = {
+  #if PROFILE_HTTP
+    SCHEDULER_TASK("web", handleClient, 0, HTTP_LOOP_BUDGET_US + 2000),
+  #endif
+  #if PROFILE_TCP
+    SCHEDULER_TASK("tcp", protocolTcpLoop, 0, 2000),
+  #endif
+  SCHEDULER_TASK("memory", sampleMemory, MEMORY_SAMPLE_MS * 1000UL, 500),
+};
+
+#define PROTOCOL_TASK_COUNT (sizeof(protocolTasks) / sizeof(protocolTasks[0]))
+#define WEB_TASK_COUNT (sizeof(webTasks) / sizeof(webTasks[0]))
+
+// Pasada del motor de protocolo; su duración alimenta el histograma de /metrics
+void protocolLoop() {
+  recordLoopTime(runTasks(protocolTasks, PROTOCOL_TASK_COUNT));
+}
+
+// Pasada del lado web: conexiones HTTP
+void webLoop() {
+  runTasks(webTasks, WEB_TASK_COUNT);
+}
+
+// Estadísticas de ambas tablas para GET /api/tasks
+void printSchedulerStats(Print& out) {
+  out.print("{\"protocol\":");
+  printTaskStats(out, protocolTasks, PROTOCOL_TASK_COUNT);
+  out.print(",\"web\":");
+  printTaskStats(out, webTasks, WEB_TASK_COUNT);
+  out.print("}");
+}
+
+// Respuesta del comando id, si ya llegó
+// Las de otros ids son de comandos que quedaron pendientes y se descartan
+static bool takeReply(uint32_t id, CommandResponse& response, char* reply, size_t replySize) {
+  QueuedReply result;
+  while (replyQueue.pop(result)) {
+    if (result.id != id) continue;
+    
+    response = result.response;
+    safeStrCopy(reply, result.reply, replySize);
+    return true;
+  }
+  return false;
+}
+
+// Encolar un pedido para la tarea de protocolo y esperar su respuesta
+static CommandResponse submitCommand(QueuedCommand& queued, char* reply, size_t replySize) {
+  CommandResponse response = {false, MSG_QUEUE_FULL, 0, ""};
+  reply[0] = '\0';
+  
+  queued.id = nextCommandId++;
+  __atomic_store_n(&awaitedCommand, queued.id, __ATOMIC_RELEASE);
+  if (!commandQueue.push(queued)) {
+    claimCommand(queued.id);
+    return response;
+  }
+  
+  #ifdef ESP32
+    unsigned long start = millis();
+    while (millis() - start < TASK_COMMAND_TIMEOUT_MS) {
+      if (takeReply(queued.id, response, reply, replySize)) return response;
+      vTaskDelay(1);
+    }
+  #endif
+  
+  // Todavía en la cola: se retira y no llega a ejecutarse
+  if (claimCommand(queued.id)) {
+    setMessage(response, MSG_TASK_TIMEOUT);
+    return response;
+  }
+  
+  // Ya empezó: puede haber terminado justo ahora
+  if (takeReply(queued.id, response, reply, replySize)) return response;
+  
+  setMessage(response, MSG_TASK_PENDING);
+  return response;
+}
+
+// Ejecutar un comando en la tarea de protocolo y esperar su respuesta
+CommandResponse runCommand(const char* command, char* reply, size_t replySize) {
+  if (!tasksRunning) return executeCaptured(command, reply, replySize);
+  
+  QueuedCommand queued;
+  queued.isConfig = false;
+  safeStrCopy(queued.command, command, sizeof(queued.command));
+  return submitCommand(queued, reply, replySize);
+}
+
+// Aplicar un cambio de configuración en la tarea de protocolo
+CommandResponse runConfigUpdate(const ConfigUpdate& update) {
+  if (!tasksRunning) return applyConfigUpdate(update);
+  
+  QueuedCommand queued;
+  queued.isConfig = true;
+  queued.update = update;
+  
+  char reply[1];
+  return submitCommand(queued, reply, sizeof(reply));
+}
+
+// Lote de comandos de la API en una sola transacción de almacenamiento
+void beginCommandBatch() {
+  beginStorageTransaction();
+}
+
+void endCommandBatch() {
+  if (!tasksRunning) {
+    commitStorageTransaction();
+    return;
+  }
+  
+  __atomic_fetch_add(&batchesToCommit, 1, __ATOMIC_ACQ_REL);
+}
+
+// Último estado publicado (sin tareas se lee directamente)
+void readStatusSnapshot(StatusSnapshot& snapshot) {
+  if (!tasksRunning) {
+    takeSnapshot(snapshot);
+    return;
+  }
+  
+  if (!snapshotMailbox.read(snapshot)) {
+    memset(&snapshot, 0, sizeof(snapshot));
+    strcpy(snapshot.statusHex, "0000");
+  }
+}
+
+size_t getTaskQueuesRam() {
+  return sizeof(commandQueue) + sizeof(replyQueue) + sizeof(snapshotMailbox) + sizeof(rxBlock);
+}
+
+bool coreTasksRunning() {
+  return tasksRunning;
+}
+
+#ifdef ESP32
+  static void protocolTask(void* param) {
+    for (;;) {
+      protocolLoop();
+      vTaskDelay(1); // Cede el núcleo a la tarea ociosa (watchdog)
+    }
+  }
+
+  static void webTask(void* param) {
+    for (;;) {
+      webLoop();
+      vTaskDelay(1);
+    }
+  }
+#endif
+
+// Crear las tareas fijadas a cada núcleo; llamar al final de setup()
+// Desde entonces loop() no debe tocar el protocolo ni el servidor web
+// (si falla la tarea de protocolo, loop() sigue llamando a protocolLoop() y webLoop())
+bool startCoreTasks() {
+  #ifdef ESP32
+    if (tasksRunning) return true;
+    
+    // La tarea web espera respuestas solo mientras las tareas están activas
+    tasksRunning = true;
+    
+    if (xTaskCreatePinnedToCore(protocolTask, PROTOCOL_TASK_NAME, PROTOCOL_TASK_STACK, NULL,
+                                PROTOCOL_TASK_PRIORITY, NULL, PROTOCOL_TASK_CORE) != pdPASS) {
+      tasksRunning = false;
+      logError("No se pudo crear la tarea de protocolo");
+      return false;
+    }
+    
+    if (xTaskCreatePinnedToCore(webTask, WEB_TASK_NAME, WEB_TASK_STACK, NULL,
+                                WEB_TASK_PRIORITY, NULL, WEB_TASK_CORE) != pdPASS) {
+      // El protocolo ya corre en su tarea: loop() solo debe llamar a webLoop()
+      logError("No se pudo crear la tarea web");
+      return false;
+    }
+    
+    return true;
+  #else
+    return false;
+  #endif
+}
@@ -0,0 +1,167 @@
+#ifndef TAREAS_H
+#define TAREAS_H
+
+#include "estructuras.h"
+#include "mensajes.h"
+#include <Arduino.h>
+
+// Reparto del trabajo entre núcleos
+// En ESP32 el protocolo RS485 y los tiempos de los relés corren en una tarea de
+// alta prioridad fijada a un núcleo, y HTTP en otra tarea fijada al núcleo de
+// WiFi. Ambas se comunican solo por colas de un productor y un consumidor (y
+// un buzón para el estado), así la actividad de red no agrega demora a las
+// respuestas del bus.
+// En ESP8266 (un solo núcleo) loop() llama a protocolLoop() y webLoop().
+// Cada pasada recorre una tabla del planificador (planificador.h).
+
+#define PROTOCOL_TASK_NAME      "protocolo"
+#define PROTOCOL_TASK_CORE      1       // Núcleo de la aplicación (sin WiFi)
+#define PROTOCOL_TASK_PRIORITY  5       // Por encima de loop() y de la tarea web
+#define PROTOCOL_TASK_STACK     4096
+#define WEB_TASK_NAME           "web"
+#define WEB_TASK_CORE           0       // Núcleo del stack WiFi/lwIP
+#define WEB_TASK_PRIORITY       1
+#define WEB_TASK_STACK          8192
+
+#define TASK_QUEUE_SIZE         4       // Elementos por cola (uno queda libre)
+#define TASK_REPLY_SIZE         80      // Respuesta del protocolo capturada
+#define TASK_COMMAND_TIMEOUT_MS 500     // Espera máxima de la tarea web por una respuesta
+#define RELAY_TICK_MS           100     // Período de updateRelays()
+#define STORAGE_POLL_MS         50      // Período de storageLoop()
+
+// Cola circular sin bloqueos para un productor y un consumidor
+// head solo lo escribe el productor y tail solo el consumidor; el índice se
+// publica con semántica release después de copiar el elemento, así el otro
+// núcleo nunca ve un elemento a medio escribir
+template <typename T, uint8_t N>
+class SpscRing {
+  public:
+    SpscRing() : head(0), tail(0) {}
+    
+    bool push(const T& item) {
+      uint8_t next = (head + 1) % N;
+      if (next == __atomic_load_n(&tail, __ATOMIC_ACQUIRE)) return false; // Llena
+      
+      items[head] = item;
+      __atomic_store_n(&head, next, __ATOMIC_RELEASE);
+      return true;
+    }
+    
+    bool pop(T& item) {
+      if (tail == __atomic_load_n(&head, __ATOMIC_ACQUIRE)) return false; // Vacía
+      
+      item = items[tail];
+      __atomic_store_n(&tail, (uint8_t)((tail + 1) % N), __ATOMIC_RELEASE);
+      return true;
+    }
+    
+  private:
+    T items[N];
+    uint8_t head;
+    uint8_t tail;
+};
+
+// Buzón de un solo elemento para publicar el último estado (seqlock)
+// El productor siempre sobrescribe: sequence queda impar mientras copia y par
+// al terminar. El consumidor repite la copia si sequence cambió en el medio,
+// así se queda siempre con el último elemento completo
+template <typename T>
+class Mailbox {
+  public:
+    Mailbox() : sequence(0) {}
+    
+    void publish(const T& item) {
+      uint32_t seq = sequence;
+      __atomic_store_n(&sequence, seq + 1, __ATOMIC_RELAXED);
+      __atomic_thread_fence(__ATOMIC_RELEASE);
+      value = item;
+      __atomic_store_n(&sequence, seq + 2, __ATOMIC_RELEASE);
+    }
+    
+    bool read(T& item) {
+      for (;;) {
+        uint32_t before = __atomic_load_n(&sequence, __ATOMIC_ACQUIRE);
+        if (before == 0) return false;   // Todavía no se publicó nada
+        if (before & 1) continue;        // Copia en curso del otro lado
+        
+        item = value;
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&sequence, __ATOMIC_RELAXED) == before) return true;
+      }
+    }
+    
+  private:
+    T value;
+    uint32_t sequence;
+};
+
+// Comando pendiente para la tarea de protocolo
+typedef struct {
+    uint32_t id;                 // Correlación con la respuesta
+    bool isConfig;               // Cambio de configuración en lugar de comando
+    union {
+        char command[64];        // Trama completa o forma corta ("S1")
+        ConfigUpdate update;     // POST /api/config
+    };
+} QueuedCommand;
+
+// Resultado de un comando ejecutado por la tarea de protocolo
+typedef struct {
+    uint32_t id;                 // Id del QueuedCommand
+    CommandResponse response;    // Resultado de processCommand
+    char reply[TASK_REPLY_SIZE]; // Trama de respuesta capturada
+} QueuedReply;
+
+// Copia del estado publicada por la tarea de protocolo
+typedef struct {
+    uint32_t version;            // statusVersion al tomar la copia
+    uint16_t status;             // Bits de status
+    char statusHex[5];           // Status en hexadecimal
+    char rfidData[16];           // Último código leído
+    uint8_t relayState[RELAY_COUNT]; // Estado de cada relé (perfil.h)
+    uint32_t configVersion;      // configVersion al tomar la copia
+    DeviceConfig config;         // Configuración vigente
+    uint8_t relayTime[RELAY_COUNT]; // Tiempo de cada relé
+} StatusSnapshot;
+
+// Arranque de las tareas (ESP32); devuelve false si no se pudieron crear
+bool startCoreTasks();
+bool coreTasksRunning();
+
+// Una pasada de cada lado (las tareas las llaman en bucle; en ESP8266, loop())
+void protocolLoop();
+void webLoop();
+
+// Ejecutar un comando del protocolo desde el lado web
+// Con las tareas activas el comando viaja por la cola y se espera la respuesta;
+// si no, se ejecuta en el momento. Cada comando corre a lo sumo una vez: si la
+// espera vence antes de que empiece se descarta (MSG_TASK_TIMEOUT) y si ya
+// empezó la respuesta queda pendiente (MSG_TASK_PENDING, ver commandPending)
+CommandResponse runCommand(const char* command, char* reply, size_t replySize);
+
+// El comando empezó en la tarea de protocolo pero su resultado no llegó a
+// tiempo: no es un fallo y reintentarlo lo ejecutaría dos veces
+inline bool commandPending(const CommandResponse& response) {
+  return response.message == MSG_TASK_PENDING;
+}
+
+// Aplicar un cambio de configuración en la tarea de protocolo (misma cola)
+CommandResponse runConfigUpdate(const ConfigUpdate& update);
+
+// Transacción de almacenamiento de un lote de comandos (POST /api/commands)
+// Se abre antes de encolar el primero. El cierre lo hace la tarea de protocolo
+// cuando no está ejecutando nada, así un comando que quedó pendiente también
+// termina dentro de la transacción
+void beginCommandBatch();
+void endCommandBatch();
+
+// Último estado publicado por la tarea de protocolo
+void readStatusSnapshot(StatusSnapshot& snapshot);
+
+// Tiempos de cada subsistema (JSON de GET /api/tasks)
+void printSchedulerStats(Print& out);
+
+// RAM estática de las colas entre tareas (memoria.h)
+size_t getTaskQueuesRam();
+
+#endif
@@ -0,0 +1,190 @@
+#include "transporte_tcp.h"
+#include "perfil.h"
+#include "protocolo.h"
+#include "pasarela.h"
+#include "servidor.h"
+#include "tareas.h"
+#include "utilidades.h"
+#include "variables.h"
+
+// Solo en perfiles con protocolo por TCP (perfil.h)
+#if PROFILE_TCP
+
+// Conexión con su propio armado de tramas y la respuesta pendiente
+struct ProtocolConnection {
+  WiFiClient client;
+  bool active;
+  unsigned long lastActivity;
+  CommandBuffer frame;
+  uint8_t rx[PROTOCOL_TCP_RX_BLOCK];   // Bloque leído, consumido trama a trama
+  size_t rxLength;
+  size_t rxPosition;
+  char tx[TASK_REPLY_SIZE];            // Respuesta de la última trama
+  size_t txLength;
+  size_t txSent;
+  bool waiting;                        // Trama en la pasarela, sin respuesta todavía
+  uint16_t tag;                        // Secuencia de la última trama enviada a la pasarela
+};
+
+static WiFiServer protocolListener(PROTOCOL_TCP_PORT);
+static ProtocolConnection tcpConnections[PROTOCOL_TCP_MAX_CLIENTS];
+static bool listening = false;
+
+void initProtocolTcp() {
+  if (config.modo_tcpip485 != TCPIP_MODE_TCP && config.modo_tcpip485 != TCPIP_MODE_GATEWAY) return;
+  
+  protocolListener.begin();
+  protocolListener.setNoDelay(true);
+  listening = true;
+}
+
+static void closeConnection(ProtocolConnection& conn) {
+  conn.client.stop();
+  conn.active = false;
+  conn.waiting = false;
+}
+
+static void acceptConnections() {
+  for (int i = 0; i < PROTOCOL_TCP_MAX_CLIENTS; i++) {
+    ProtocolConnection& conn = tcpConnections[i];
+    if (conn.active) continue;
+    
+    if (!protocolListener.hasClient()) return;
+    
+    conn.client = protocolListener.available();
+    if (!conn.client) return;
+    
+    // Sin Nagle: cada respuesta corta sale en cuanto se escribe
+    conn.client.setNoDelay(true);
+    conn.active = true;
+    conn.lastActivity = millis();
+    conn.rxLength = 0;
+    conn.rxPosition = 0;
+    conn.txLength = 0;
+    conn.txSent = 0;
+    conn.waiting = false;
+    resetFrame(conn.frame);
+    metrics.tcpAccepted++;
+  }
+}
+
+// Enviar lo que quede de la respuesta; false mientras no terminó
+static bool flushReply(ProtocolConnection& conn) {
+  if (conn.txSent >= conn.txLength) return true;
+  
+  int n = writeSome(conn.client, conn.tx + conn.txSent, conn.txLength - conn.txSent);
+  if (n < 0) {
+    closeConnection(conn);
+    return false;
+  }
+  
+  conn.txSent += n;
+  if (conn.txSent < conn.txLength) return false;
+  
+  conn.txLength = 0;
+  conn.txSent = 0;
+  return true;
+}
+
+// Armar tramas con lo recibido; se detiene en cada trama completa para no
+// acumular más de una respuesta por conexión (el resto espera en rx o en el
+// socket). Lee del socket una vez por pasada para no acaparar la tarea web
+static void receiveFrames(ProtocolConnection& conn) {
+  bool readDone = false;
+  
+  while (conn.txLength == 0 && !conn.waiting) {
+    if (conn.rxPosition >= conn.rxLength) {
+      if (readDone) return;
+      readDone = true;
+      
+      int available = conn.client.available();
+      if (available <= 0) {
+        if (!conn.client.connected()) closeConnection(conn);
+        return;
+      }
+      
+      int n = conn.client.read(conn.rx, min((size_t)available, sizeof(conn.rx)));
+      if (n <= 0) {
+        if (!conn.client.connected()) closeConnection(conn);
+        return;
+      }
+      
+      conn.rxLength = n;
+      conn.rxPosition = 0;
+      conn.lastActivity = millis();
+    }
+    
+    while (conn.rxPosition < conn.rxLength) {
+      if (!frameIncomingByte(conn.frame, conn.rx[conn.rxPosition++])) continue;
+      
+      // Trama para otro equipo: la respuesta llega después por la pasarela
+      #if PROFILE_GATEWAY
+        if (isGatewayFrame(conn.frame.buffer)) {
+          conn.waiting = gatewaySubmit(&conn - tcpConnections, ++conn.tag, conn.frame.buffer);
+          resetFrame(conn.frame);
+          break;
+        }
+      #endif
+      
+      runCommand(conn.frame.buffer, conn.tx, sizeof(conn.tx));
+      conn.txLength = strlen(conn.tx); // 0 si la trama era para otro ID
+      conn.txSent = 0;
+      resetFrame(conn.frame);
+      break;
+    }
+    
+    if (!flushReply(conn)) return;
+  }
+}
+
+// Respuestas de la pasarela para las conexiones que siguen esperando
+#if PROFILE_GATEWAY
+static void collectGatewayReplies() {
+  GatewayReply reply;
+  while (gatewayPollReply(reply)) {
+    ProtocolConnection& conn = tcpConnections[reply.slot];
+    if (!conn.active || !conn.waiting || conn.tag != reply.tag) continue;
+    
+    safeStrCopy(conn.tx, reply.frame, sizeof(conn.tx));
+    conn.txLength = strlen(conn.tx); // 0 si el equipo no respondió
+    conn.txSent = 0;
+    conn.waiting = false;
+  }
+}
+#endif
+
+void protocolTcpLoop() {
+  if (!listening) return;
+  
+  acceptConnections();
+  #if PROFILE_GATEWAY
+    collectGatewayReplies();
+  #endif
+  
+  for (int i = 0; i < PROTOCOL_TCP_MAX_CLIENTS; i++) {
+    ProtocolConnection& conn = tcpConnections[i];
+    if (!conn.active) continue;
+    
+    if (!flushReply(conn)) continue;
+    
+    receiveFrames(conn);
+    
+    if (conn.active && millis() - conn.lastActivity > PROTOCOL_TCP_IDLE_MS) {
+      closeConnection(conn);
+    }
+  }
+}
+
+uint8_t getProtocolTcpClients() {
+  uint8_t count = 0;
+  for (int i = 0; i < PROTOCOL_TCP_MAX_CLIENTS; i++) {
+    if (tcpConnections[i].active) count++;
+  }
+  return count;
+}
+
+size_t getProtocolTcpRam() {
+  return sizeof(tcpConnections);
+}
+
+#endif
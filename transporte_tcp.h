@@ -0,0 +1,29 @@
+#ifndef TRANSPORTE_TCP_H
+#define TRANSPORTE_TCP_H
+
+#include <Arduino.h>
+
+// Protocolo STX/ETX sobre TCP
+// Servidor sin bloqueo para varios clientes a la vez: cada conexión tiene su
+// propio armado de tramas y la respuesta vuelve por el mismo socket. Se
+// habilita con modo_tcpip485 = TCPIP_MODE_TCP (A6) y convive con el bus.
+// En TCPIP_MODE_GATEWAY las tramas para otros IDs pasan al bus (pasarela.h).
+
+#define PROTOCOL_TCP_PORT         4001
+#define PROTOCOL_TCP_MAX_CLIENTS  4
+#define PROTOCOL_TCP_IDLE_MS      120000  // Cierre de conexiones sin tráfico
+#define PROTOCOL_TCP_RX_BLOCK     64      // Bytes leídos del socket de una vez
+
+// Abrir el puerto si el modo lo pide (llamar después de conectar la red)
+void initProtocolTcp();
+
+// Atender conexiones sin bloquear (tarea web)
+void protocolTcpLoop();
+
+// Clientes conectados
+uint8_t getProtocolTcpClients();
+
+// RAM estática de las conexiones (memoria.h)
+size_t getProtocolTcpRam();
+
+#endif
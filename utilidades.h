@@ -1,41 +1,68 @@
-#ifndef UTILIDADES_H
-#define UTILIDADES_H
-
-#include <Arduino.h>
-#include "estructuras.h"
-
-// Conversión hexadecimal/ASCII
-char hex2ascii(uint8_t hex);
-uint8_t ascii2hex(char ascii);
-
-// Conversiones de texto
-void uint16ToHexStr(uint16_t value, char* buffer);
-uint16_t hexStrToUint16(const char* hexStr);
-
-// Manipulación de status
-void setStatusBit(uint16_t bit);
-void clearStatusBit(uint16_t bit);
-bool isStatusBitSet(uint16_t bit);
-void updateStatusHexString();
-
-// Funciones de debug
-void logDebug(const char* message);
-void logError(const char* message);
-void logCommand(const char* prefix, const char* cmd);
-
-// Funciones para tiempo y espera
-void delayMs(unsigned long ms);
-unsigned long getMillis();
-bool hasTimePassed(unsigned long startTime, unsigned long duration);
-
-// Control de TX/RX para RS485
-void setTxMode();
-void setRxMode();
-
-// Gestión de strings
-void safeStrCopy(char* dest, const char* src, size_t destSize);
-bool startsWith(const char* str, const char* prefix);
-void byteArrayToHexString(const uint8_t* array, size_t len, char* result);
-void hexStringToByteArray(const char* hexStr, uint8_t* array, size_t maxLen);
-
+#ifndef UTILIDADES_H
+#define UTILIDADES_H
+
+#include <Arduino.h>
+#include "estructuras.h"
+
+// Conversión hexadecimal/ASCII
+char hex2ascii(uint8_t hex);
+uint8_t ascii2hex(char ascii);
+
+// Conversiones de texto
+void uint16ToHexStr(uint16_t value, char* buffer);
+uint16_t hexStrToUint16(const char* hexStr);
+
+// Manipulación de status
+void setStatusBit(uint16_t bit);
+void clearStatusBit(uint16_t bit);
+bool isStatusBitSet(uint16_t bit);
+void updateStatusHexString();
+
+// Funciones de debug
+void logDebug(const char* message);
+void logError(const char* message);
+void logCommand(const char* prefix, const char* cmd);
+
+// Funciones para tiempo y espera
+void delayMs(unsigned long ms);
+unsigned long getMillis();
+bool hasTimePassed(unsigned long startTime, unsigned long duration);
+
+// Control de TX/RX para RS485
+void setTxMode();
+void setRxMode();
+
+// Gestión de strings
+void safeStrCopy(char* dest, const char* src, size_t destSize);
+bool startsWith(const char* str, const char* prefix);
+void byteArrayToHexString(const uint8_t* array, size_t len, char* result);
+void hexStringToByteArray(const char* hexStr, uint8_t* array, size_t maxLen);
+
+// Verificación de integridad
+uint16_t crc16(const uint8_t* data, size_t len);
+
+// Salida Print sobre un buffer fijo que detecta desbordes
+class BufferPrint : public Print {
+  public:
+    BufferPrint(char* buffer, size_t size) : buffer(buffer), size(size), length(0), overflow(false) {}
+    
+    size_t write(uint8_t c) override {
+      if (length >= size) {
+        overflow = true;
+        return 0;
+      }
+      buffer[length++] = c;
+      return 1;
+    }
+    
+    size_t written() const { return length; }
+    bool overflowed() const { return overflow; }
+    
+  private:
+    char* buffer;
+    size_t size;
+    size_t length;
+    bool overflow;
+};
+
 #endif
\ No newline at end of file
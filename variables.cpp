@@ -1,23 +1,26 @@
-#include "variables.h"
-
-// Definición de variables globales (estas irán en un archivo .cpp)
-DeviceConfig config;
-StatusInfo statusInfo;
-CommandBuffer cmdBuffer;
-RelayInfo relays[5];
-
-// Pines (modificar según tu hardware)
-#ifdef ESP8266
-int DE_RE_PIN = D4;      // Pin DE/RE para RS485
-int RELAY_PINS[5] = {    // Pines para los relés
-  D5, D6, D7, D8, D0
-};
-#elif defined(ESP32)
-int DE_RE_PIN = 4;       // Pin DE/RE para RS485
-int RELAY_PINS[5] = {    // Pines para los relés
-  5, 18, 19, 21, 22
-};
-#endif
-
-// Velocidad de comunicación RS485
+#include "variables.h"
+
+// Definición de variables globales (estas irán en un archivo .cpp)
+DeviceConfig config;
+StatusInfo statusInfo;
+CommandBuffer cmdBuffer;
+RelayInfo relays[RELAY_COUNT];
+uint32_t statusVersion = 0;
+uint32_t configVersion = 0;
+Metrics metrics;
+
+// Pines (modificar según tu hardware)
+#ifdef ESP8266
+int DE_RE_PIN = D1;      // Pin DE/RE para RS485 (D4/GPIO2 es el TX de los logs)
+int RELAY_PINS[5] = {    // Pines para los relés (D7/D8 son RX/TX de RS485;
+  D5, D6, D2, RX, D0     // GPIO3 queda libre al intercambiar la UART0)
+};
+#elif defined(ESP32)
+int DE_RE_PIN = 4;       // Pin DE/RE para RS485
+int RELAY_PINS[5] = {    // Pines para los relés
+  5, 18, 19, 21, 22
+};
+#endif
+
+// Velocidad de comunicación RS485
 int RS485_BAUDRATE = 9600;
\ No newline at end of file
@@ -1,57 +1,129 @@
-#include "web.h"
-#include "variables.h"
-
-#ifdef ESP8266
-  #include <ESP8266WebServer.h>
-  extern ESP8266WebServer server;
-#elif defined(ESP32)
-  #include <WebServer.h>
-  extern WebServer server;
-#endif
-
-// Configuración del servidor web
-void setupWebServer() {
-  // Configurar rutas para páginas web
-  server.on("/", HTTP_GET, handleRoot);
-  server.onNotFound(handleNotFound);
-}
-
-// Página principal
-void handleRoot() {
-  String html = "<html><head><title>OemAccess API</title></head><body>";
-  html += "<h1>OemAccess API</h1>";
-  html += "<p>Dispositivo ID: " + String(config.deviceId) + "</p>";
-  html += "<p>Nombre: " + String(config.nombre_empresa) + "</p>";
-  html += "<h2>Endpoints disponibles:</h2>";
-  html += "<ul>";
-  html += "<li>GET /api/status - Obtener estado actual</li>";
-  html += "<li>POST /api/relay?relay=1&action=activate - Activar relé 1</li>";
-  html += "<li>POST /api/relay?relay=1&action=deactivate - Desactivar relé 1</li>";
-  html += "<li>POST /api/command?command=S1 - Enviar comando S1 (activa relé 1)</li>";
-  html += "<li>POST /api/command?command=R1 - Enviar comando R1 (desactiva relé 1)</li>";
-  html += "<li>GET /api/config - Obtener configuración</li>";
-  html += "<li>POST /api/reset - Reiniciar dispositivo</li>";
-  html += "</ul>";
-  html += "</body></html>";
-  
-  server.send(200, "text/html", html);
-}
-
-// Página no encontrada
-void handleNotFound() {
-  String message = "Página no encontrada\n\n";
-  message += "URI: ";
-  message += server.uri();
-  message += "\nMétodo: ";
-  message += (server.method() == HTTP_GET) ? "GET" : "POST";
-  message += "\nArgumentos: ";
-  message += server.args();
-  message += "\n";
-  
-  for (uint8_t i = 0; i < server.args(); i++) {
-    message += " " + server.argName(i) + ": " + server.arg(i) + "\n";
-  }
-  
-  server.send(404, "text/plain", message);
-}
-
+#include "web.h"
+#include "perfil.h"
+#include "variables.h"
+#include "servidor.h"
+#include "arena.h"
+
+// Solo en perfiles con servidor HTTP (perfil.h)
+#if PROFILE_HTTP
+
+#if PROFILE_WEB_UI
+  #include "web_assets.h"
+#endif
+
+// Configuración del servidor web
+void setupWebServer() {
+  #if PROFILE_WEB_UI
+    // Cabeceras que el servidor debe conservar para las validaciones de caché
+    static const char* cacheHeaders[] = {"If-None-Match"};
+    server.collectHeaders(cacheHeaders, 1);
+    
+    // Configurar rutas para páginas web
+    server.on(assetIndex.path, HTTP_GET, handleRoot);
+    server.on(assetConfigPage.path, HTTP_GET, serveConfigPage);
+    server.on(assetStylesheet.path, HTTP_GET, serveStylesheet);
+    server.on(assetScript.path, HTTP_GET, serveScript);
+  #endif
+  server.onNotFound(handleNotFound);
+  server.begin();
+}
+
+// Atender las conexiones HTTP pendientes (llamar en cada vuelta de loop())
+void handleClient() {
+  server.handleClient();
+}
+
+#if PROFILE_WEB_UI
+
+// Enviar un recurso comprimido directamente desde flash
+// Las páginas se revalidan con ETag (304 sin cuerpo); la hoja de estilos y el
+// script llevan la versión en la URL y se cachean sin vencimiento
+static void serveAsset(const WebAsset& asset) {
+  server.sendHeader("ETag", asset.etag);
+  server.sendHeader("Cache-Control", asset.immutable ? "public, max-age=31536000, immutable" : "no-cache");
+  
+  if (strcmp(server.header("If-None-Match"), asset.etag) == 0) {
+    server.send(304);
+    return;
+  }
+  
+  server.sendHeader("Content-Encoding", "gzip");
+  server.send_P(200, asset.contentType, (PGM_P)asset.data, asset.length);
+}
+
+// Página principal (los datos los carga app.js desde /api/status y /api/config)
+void handleRoot() {
+  serveAsset(assetIndex);
+}
+
+void serveConfigPage() {
+  serveAsset(assetConfigPage);
+}
+
+void serveStylesheet() {
+  serveAsset(assetStylesheet);
+}
+
+void serveScript() {
+  serveAsset(assetScript);
+}
+
+#endif
+
+// Página no encontrada (el texto se arma en la arena del pedido)
+void handleNotFound() {
+  ArenaPrint message;
+  message.print("Página no encontrada\n\n");
+  message.print("URI: ");
+  message.print(server.uri());
+  message.print("\nMétodo: ");
+  message.print((server.method() == HTTP_GET) ? "GET" : "POST");
+  message.print("\nArgumentos: ");
+  message.print(server.args());
+  message.print("\n");
+  
+  for (uint8_t i = 0; i < server.args(); i++) {
+    message.print(" ");
+    message.print(server.argName(i));
+    message.print(": ");
+    message.print(server.arg(i));
+    message.print("\n");
+  }
+  
+  server.send(404, "text/plain", message.c_str());
+}
+
+// Respuesta escrita por partes
+void ChunkedResponse::begin(int code, const char* contentType) {
+  server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  server.send(code, contentType, "");
+}
+
+// Respuesta que no entra en la conexión: toma antes el buffer grande del servidor
+// Si lo usa otra conexión se responde 503 y el manejador no debe hacer nada más
+bool ChunkedResponse::beginLarge(int code, const char* contentType) {
+  if (!server.reserveLargeBody()) {
+    server.sendHeader("Retry-After", "1");
+    server.send(503, "text/plain", "Servidor ocupado");
+    return false;
+  }
+  
+  begin(code, contentType);
+  return true;
+}
+
+size_t ChunkedResponse::write(uint8_t c) {
+  server.sendContent((const char*)&c, 1);
+  return 1;
+}
+
+size_t ChunkedResponse::write(const uint8_t* data, size_t len) {
+  server.sendContent((const char*)data, len);
+  return len;
+}
+
+// El servidor cierra la respuesta al volver el manejador
+void ChunkedResponse::end() {
+}
+
+#endif
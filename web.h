@@ -1,34 +1,57 @@
-#ifndef WEB_H
-#define WEB_H
-
-#include <Arduino.h>
-
-// Configuración del servidor web
-void setupWebServer();
-void handleClient();
-
-// Páginas y assets web
-void handleRoot();
-void handleNotFound();
-void serveConfigPage();
-void serveStylesheet();
-void serveScript();
-
-// WebSocket (para actualizaciones en tiempo real)
-void setupWebSocket();
-void handleWebSocketEvent(uint8_t num, uint8_t type, uint8_t* payload, size_t length);
-void broadcastStatus();
-
-// Autenticación
-bool isAuthenticated();
-void handleAuthentication();
-void handleLogout();
-
-// Utilidades Web
-String getContentType(const String& path);
-String urlDecode(const String& text);
-void sendJsonResponse(int code, const String& json);
-void sendTextResponse(int code, const String& text, const String& contentType);
-void redirectTo(const String& url);
-
+#ifndef WEB_H
+#define WEB_H
+
+#include <Arduino.h>
+
+// Recurso de la interfaz web comprimido en gzip y guardado en flash
+// (generado en web_assets.h por web/generar_assets.py)
+typedef struct {
+  const char* path;            // Ruta HTTP
+  const char* contentType;
+  const uint8_t* data;         // Contenido gzip en PROGMEM
+  size_t length;
+  const char* etag;            // CRC32 del contenido comprimido, entre comillas
+  bool immutable;              // Se referencia con ?v=<etag>: cache sin vencimiento
+} WebAsset;
+
+// Respuesta HTTP escrita por partes
+// Lo escrito va directo al cuerpo de la conexión del servidor (o a su buffer
+// grande si no entra) y se envía cuando vuelve el manejador
+class ChunkedResponse : public Print {
+  public:
+    void begin(int code, const char* contentType);
+    bool beginLarge(int code, const char* contentType);   // false: buffer grande ocupado, ya respondió 503
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* data, size_t len) override;
+    void end();
+};
+
+// Configuración del servidor web
+void setupWebServer();
+void handleClient();
+
+// Páginas y assets web
+void handleRoot();
+void handleNotFound();
+void serveConfigPage();
+void serveStylesheet();
+void serveScript();
+
+// WebSocket (para actualizaciones en tiempo real)
+void setupWebSocket();
+void handleWebSocketEvent(uint8_t num, uint8_t type, uint8_t* payload, size_t length);
+void broadcastStatus();
+
+// Autenticación
+bool isAuthenticated();
+void handleAuthentication();
+void handleLogout();
+
+// Utilidades Web
+const char* getContentType(const char* path);
+const char* urlDecode(const char* text);   // Copia decodificada en la arena del pedido
+void sendJsonResponse(int code, const char* json);
+void sendTextResponse(int code, const char* text, const char* contentType);
+void redirectTo(const char* url);
+
 #endif
\ No newline at end of file
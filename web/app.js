@@ -0,0 +1,89 @@
+// Interfaz web de OemAccess: los valores dinámicos salen de la API REST.
+// Las consultas periódicas revalidan con ETag, así que casi siempre son 304.
+function $(id) { return document.getElementById(id); }
+
+function getJson(url) {
+  return fetch(url, {cache: 'no-cache'}).then(function (r) { return r.json(); });
+}
+
+function post(url, body) {
+  var options = {method: 'POST'};
+  if (body !== undefined) {
+    options.headers = {'Content-Type': 'application/json'};
+    options.body = JSON.stringify(body);
+  }
+  return fetch(url, options).then(function (r) { return r.json(); });
+}
+
+function showReply(data) {
+  $('reply').textContent = JSON.stringify(data, null, 2);
+}
+
+// Panel principal
+function refreshStatus() {
+  getJson('/api/status').then(function (s) {
+    $('statusHex').textContent = s.statusHex;
+    var html = '';
+    for (var name in s.bits) {
+      html += '<span class="bit' + (s.bits[name] ? ' on' : '') + '">' + name + '</span>';
+    }
+    $('bits').innerHTML = html;
+  });
+}
+
+function refreshConfig() {
+  getJson('/api/config').then(function (c) {
+    $('deviceId').textContent = c.deviceIdStr;
+    $('companyName').textContent = c.companyName;
+    $('workMode').textContent = c.workMode;
+    $('door').textContent = c.isEntrance ? 'Entrada' : 'Salida';
+    var html = '';
+    c.relays.forEach(function (r) {
+      html += '<div>Relé ' + r.number + ' (estado ' + r.state + ') ' +
+              '<button data-relay="' + r.number + '" data-action="activate">Activar</button>' +
+              '<button class="off" data-relay="' + r.number + '" data-action="deactivate">Desactivar</button></div>';
+    });
+    $('relays').innerHTML = html;
+  });
+}
+
+function setupDashboard() {
+  document.addEventListener('click', function (e) {
+    var b = e.target;
+    if (b.dataset.relay) {
+      post('/api/relay?relay=' + b.dataset.relay + '&action=' + b.dataset.action).then(refreshConfig);
+    } else if (b.dataset.command) {
+      post('/api/command?command=' + encodeURIComponent(b.dataset.command)).then(showReply);
+    }
+  });
+  refreshStatus();
+  refreshConfig();
+  setInterval(refreshStatus, 1000);
+  setInterval(refreshConfig, 5000);
+}
+
+// Página de configuración
+function setupConfigForm() {
+  var form = $('config');
+  getJson('/api/config').then(function (c) {
+    form.deviceId.value = c.deviceId;
+    form.companyName.value = c.companyName;
+    form.workMode.value = c.workMode;
+    form.relay1Time.value = c.relays[0].time;
+    form.relay2Time.value = c.relays[1].time;
+  });
+  form.addEventListener('submit', function (e) {
+    e.preventDefault();
+    post('/api/config', {
+      deviceId: +form.deviceId.value,
+      companyName: form.companyName.value,
+      workMode: +form.workMode.value,
+      relays: [
+        {number: 1, time: +form.relay1Time.value},
+        {number: 2, time: +form.relay2Time.value}
+      ]
+    }).then(showReply);
+  });
+}
+
+if ($('config')) setupConfigForm(); else setupDashboard();
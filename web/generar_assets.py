@@ -0,0 +1,68 @@
+#!/usr/bin/env python3
+# Genera web_assets.h con la interfaz web comprimida en gzip para PROGMEM.
+# Ejecutar después de modificar cualquier archivo de web/:
+#   python3 web/generar_assets.py
+#
+# Las páginas HTML se revalidan con ETag en cada carga; la hoja de estilos y
+# el script se referencian con ?v=<etag>, así que pueden cachearse sin límite.
+
+import gzip
+import os
+import zlib
+
+WEB_DIR = os.path.dirname(os.path.abspath(__file__))
+OUTPUT = os.path.join(WEB_DIR, '..', 'web_assets.h')
+
+# (archivo, ruta HTTP, Content-Type, nombre en C, inmutable)
+ASSETS = [
+    ('estilos.css', '/estilos.css', 'text/css', 'assetStylesheet', True),
+    ('app.js', '/app.js', 'application/javascript', 'assetScript', True),
+    ('index.html', '/', 'text/html', 'assetIndex', False),
+    ('config.html', '/config', 'text/html', 'assetConfigPage', False),
+]
+
+
+def etag_of(data):
+    return '%08x' % (zlib.crc32(data) & 0xFFFFFFFF)
+
+
+def main():
+    versions = {}
+    blocks = []
+
+    for filename, path, content_type, name, immutable in ASSETS:
+        with open(os.path.join(WEB_DIR, filename), 'rb') as f:
+            data = f.read()
+
+        # Referencias versionadas a los recursos inmutables ya generados
+        for ref, version in versions.items():
+            data = data.replace(('"%s"' % ref).encode(), ('"%s?v=%s"' % (ref, version)).encode())
+
+        compressed = gzip.compress(data, compresslevel=9, mtime=0)
+        etag = etag_of(compressed)
+        if immutable:
+            versions[path] = etag
+
+        lines = []
+        for i in range(0, len(compressed), 16):
+            lines.append('  ' + ', '.join('0x%02x' % b for b in compressed[i:i + 16]) + ',')
+
+        blocks.append(
+            '// %s (%d bytes, %d comprimido)\n'
+            'static const uint8_t %sData[] PROGMEM = {\n%s\n};\n\n'
+            'static const WebAsset %s = {\n'
+            '  "%s", "%s", %sData, sizeof(%sData), "\\"%s\\"", %s\n'
+            '};\n' % (filename, len(data), len(compressed), name, '\n'.join(lines),
+                      name, path, content_type, name, name, etag, 'true' if immutable else 'false'))
+
+    with open(OUTPUT, 'w', newline='\r\n') as out:
+        out.write('// Generado por web/generar_assets.py a partir de los archivos de web/\n')
+        out.write('// No editar a mano\n\n')
+        out.write('#ifndef WEB_ASSETS_H\n#define WEB_ASSETS_H\n\n')
+        out.write('#include "web.h"\n\n')
+        out.write('\n'.join(blocks))
+        out.write('\n#endif\n')
+
+
+if __name__ == '__main__':
+    main()
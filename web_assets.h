@@ -0,0 +1,211 @@
+// Generado por web/generar_assets.py a partir de los archivos de web/
+// No editar a mano
+
+#ifndef WEB_ASSETS_H
+#define WEB_ASSETS_H
+
+#include "web.h"
+
+// estilos.css (831 bytes, 405 comprimido)
+static const uint8_t assetStylesheetData[] PROGMEM = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x85, 0x52, 0xdd, 0x6e, 0xc2, 0x20,
+  0x14, 0xbe, 0xef, 0x53, 0x98, 0x98, 0xdd, 0x89, 0xc1, 0xfe, 0x18, 0x87, 0x57, 0x66, 0xc9, 0xde,
+  0xe3, 0x50, 0xa8, 0x25, 0x52, 0x20, 0x94, 0xce, 0xba, 0x86, 0x77, 0x1f, 0xe8, 0x5a, 0xad, 0x33,
+  0x59, 0x7a, 0xc3, 0x39, 0x94, 0xef, 0xef, 0x1c, 0xaa, 0xd9, 0x65, 0xa8, 0xb4, 0x72, 0xa8, 0x82,
+  0x46, 0xc8, 0x0b, 0x39, 0x58, 0x01, 0x72, 0xdf, 0x80, 0x3d, 0x0a, 0x45, 0xf0, 0xde, 0x00, 0x63,
+  0x42, 0x1d, 0x49, 0x8a, 0x4d, 0xef, 0x93, 0x75, 0x19, 0xfe, 0x04, 0xa1, 0xb8, 0x1d, 0x1a, 0xe8,
+  0xd1, 0x59, 0x30, 0x57, 0x93, 0x1d, 0x0e, 0x77, 0xd3, 0x8b, 0x05, 0x74, 0x4e, 0xfb, 0xa4, 0xde,
+  0x0c, 0xa5, 0x96, 0xda, 0x92, 0x65, 0x96, 0x65, 0xbe, 0x4e, 0xc7, 0x6a, 0xbb, 0xdd, 0x46, 0x18,
+  0xb0, 0x6c, 0xa0, 0x50, 0x9e, 0x8e, 0x56, 0x77, 0x8a, 0x91, 0x65, 0x55, 0xc4, 0x6f, 0x4f, 0xb5,
+  0x65, 0xdc, 0x22, 0x0b, 0x4c, 0x74, 0x2d, 0x29, 0x02, 0xec, 0xc8, 0xbf, 0x29, 0x26, 0x0e, 0x44,
+  0xb5, 0x73, 0xba, 0xb9, 0xb6, 0x7c, 0x42, 0xbb, 0x50, 0xa8, 0x19, 0x58, 0xfe, 0x71, 0xf8, 0x2c,
+  0xf0, 0xfe, 0xc6, 0x78, 0xae, 0x85, 0xe3, 0xbf, 0xc0, 0x44, 0x69, 0xc5, 0xef, 0x90, 0x41, 0xf6,
+  0xe2, 0x01, 0xf7, 0xca, 0x37, 0x57, 0x90, 0x87, 0x4e, 0xd9, 0xd9, 0x36, 0xe0, 0x18, 0x2d, 0x94,
+  0xe3, 0x76, 0x24, 0x24, 0xb5, 0xfe, 0x0a, 0x29, 0xcc, 0x68, 0x0b, 0xc0, 0xf9, 0x7b, 0x70, 0xa7,
+  0xab, 0x6a, 0x6e, 0x2e, 0xcf, 0xb3, 0x6c, 0xeb, 0x63, 0xff, 0xc5, 0x33, 0x96, 0xa5, 0x55, 0x5a,
+  0xf9, 0xc4, 0x01, 0x95, 0x7c, 0xb8, 0x45, 0xba, 0xc1, 0xf8, 0x6d, 0x94, 0x12, 0x6c, 0x48, 0x30,
+  0x2d, 0x27, 0xe3, 0xe1, 0x29, 0x86, 0xdb, 0x64, 0x5c, 0xbd, 0x72, 0x6c, 0x70, 0xbc, 0x77, 0x08,
+  0xa4, 0x38, 0x2a, 0x22, 0x79, 0xe5, 0x26, 0xab, 0xbb, 0xbb, 0xb3, 0x31, 0xbc, 0xe0, 0xbd, 0xd5,
+  0x52, 0xb0, 0xc5, 0x92, 0x31, 0xe6, 0x13, 0x09, 0x94, 0xcb, 0x81, 0x89, 0xd6, 0x48, 0xb8, 0x10,
+  0x2a, 0x75, 0x79, 0x1a, 0x63, 0xb9, 0xe6, 0x84, 0x17, 0xd7, 0xb4, 0x85, 0x32, 0x9d, 0x5b, 0xb5,
+  0x5c, 0xf2, 0xd2, 0x3d, 0x6a, 0x7d, 0x24, 0x7a, 0x9a, 0x12, 0x9e, 0xb8, 0x9f, 0x48, 0x5f, 0x64,
+  0x4d, 0x75, 0x8f, 0x5a, 0xf1, 0x1d, 0x91, 0x26, 0xb9, 0x71, 0xed, 0xa8, 0x70, 0x93, 0x36, 0xa1,
+  0x64, 0x58, 0x40, 0x74, 0x93, 0x38, 0xf2, 0x66, 0x01, 0xf9, 0xce, 0x4d, 0xd2, 0x3f, 0x93, 0xcc,
+  0x62, 0xe7, 0x31, 0xf5, 0x68, 0x3a, 0xe2, 0xae, 0xff, 0x5d, 0x1e, 0x9f, 0x18, 0x1b, 0x06, 0x13,
+  0x8f, 0xa8, 0x35, 0x50, 0x72, 0x12, 0x6a, 0x74, 0xb6, 0x60, 0x7c, 0xf2, 0x03, 0xa0, 0xb3, 0x13,
+  0xca, 0x3f, 0x03, 0x00, 0x00,
+};
+
+static const WebAsset assetStylesheet = {
+  "/estilos.css", "text/css", assetStylesheetData, sizeof(assetStylesheetData), "\"48bd994b\"", true
+};
+
+// app.js (2937 bytes, 1146 comprimido)
+static const uint8_t assetScriptData[] PROGMEM = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x9d, 0x56, 0xcd, 0x72, 0xe2, 0x46,
+  0x10, 0xbe, 0xf3, 0x14, 0x1d, 0x6a, 0x2b, 0x12, 0x65, 0x2c, 0x6c, 0x27, 0xb9, 0x80, 0xb1, 0xcb,
+  0xd9, 0x75, 0x6a, 0xbd, 0xe5, 0x5d, 0xbb, 0x0c, 0x39, 0xb9, 0x7c, 0x18, 0x34, 0x2d, 0x33, 0x59,
+  0x69, 0xa4, 0xcc, 0x8c, 0xf0, 0x12, 0x17, 0x0f, 0xb3, 0xc7, 0x1c, 0x72, 0xca, 0x23, 0xf8, 0xc5,
+  0xd2, 0x33, 0x23, 0x81, 0x00, 0x39, 0x95, 0x0d, 0x17, 0xc4, 0xf4, 0xd7, 0x5f, 0xf7, 0x7c, 0xfd,
+  0x83, 0x06, 0x03, 0xb8, 0x92, 0x06, 0x55, 0xc2, 0xfe, 0x80, 0x27, 0x9c, 0x01, 0x47, 0xb8, 0xc1,
+  0xec, 0x22, 0x8e, 0x51, 0xeb, 0x21, 0xa4, 0xb9, 0x86, 0x05, 0x4b, 0x73, 0x85, 0x1a, 0xb8, 0x90,
+  0x2f, 0x5f, 0x33, 0x11, 0xd3, 0x91, 0x66, 0x29, 0x4a, 0x0b, 0x4d, 0x19, 0x5c, 0xdc, 0x5e, 0xc1,
+  0xdd, 0xe5, 0x64, 0x1a, 0x75, 0x06, 0x03, 0xb8, 0x66, 0x1a, 0xe2, 0x5c, 0xea, 0x32, 0x35, 0xf4,
+  0x54, 0xa0, 0x12, 0x2f, 0x7f, 0x73, 0x11, 0xd3, 0xb3, 0x42, 0xe2, 0x11, 0x9c, 0x49, 0x6b, 0x87,
+  0xcb, 0x29, 0x7b, 0xec, 0x03, 0xd3, 0x2f, 0x7f, 0xc1, 0xef, 0x25, 0x02, 0x01, 0x04, 0x68, 0x81,
+  0x59, 0xa1, 0x10, 0x34, 0xd9, 0x7f, 0x38, 0xfa, 0x31, 0xea, 0x24, 0xa5, 0x8c, 0x8d, 0xa0, 0x5f,
+  0x6f, 0x42, 0xc1, 0x7b, 0xf0, 0x4c, 0x1c, 0xa6, 0x54, 0x14, 0x37, 0x8f, 0xcb, 0x0c, 0xa5, 0x89,
+  0x1e, 0xd1, 0x5c, 0xa6, 0x68, 0x1f, 0x7f, 0x5e, 0x5e, 0x71, 0x0b, 0x1a, 0xc1, 0xaa, 0xb3, 0xf1,
+  0x23, 0xfb, 0x07, 0x62, 0x0b, 0x4b, 0x95, 0x92, 0x7b, 0x07, 0x6a, 0x82, 0x04, 0x4d, 0x3c, 0xb7,
+  0xa7, 0x7d, 0x78, 0x8e, 0x59, 0x3c, 0xc7, 0x21, 0x04, 0x32, 0x3f, 0x74, 0x8f, 0xc1, 0xaa, 0x17,
+  0x99, 0x39, 0xca, 0x70, 0xcd, 0x12, 0xaa, 0x46, 0x6c, 0x15, 0xfd, 0x66, 0x19, 0x6d, 0xa0, 0xde,
+  0xa8, 0xd3, 0x0c, 0x56, 0xe4, 0xda, 0x78, 0xce, 0x59, 0xce, 0x97, 0x3e, 0xde, 0x82, 0x29, 0xc8,
+  0x0b, 0x6b, 0xd6, 0x30, 0x86, 0xe7, 0x0c, 0xcd, 0x3c, 0xe7, 0x14, 0xec, 0xf6, 0x66, 0x32, 0x0d,
+  0x56, 0x23, 0x42, 0x88, 0x04, 0x42, 0x8b, 0x87, 0xef, 0xc6, 0x63, 0x28, 0x25, 0xc7, 0x44, 0x48,
+  0xe4, 0xde, 0x1b, 0x6a, 0xdf, 0x68, 0x8e, 0x8c, 0xa3, 0x72, 0x1c, 0xc1, 0xdb, 0x9c, 0xca, 0x25,
+  0xcd, 0xe1, 0x74, 0x59, 0x60, 0x40, 0x5c, 0xac, 0x28, 0x52, 0x52, 0xd8, 0x02, 0x07, 0x36, 0x37,
+  0xcf, 0xbb, 0xf1, 0x75, 0xec, 0x63, 0xf8, 0x30, 0xb9, 0xf9, 0x14, 0x69, 0xa3, 0x84, 0x7c, 0x14,
+  0xc9, 0xd2, 0xc5, 0xec, 0x59, 0xe0, 0xaa, 0x55, 0x96, 0xca, 0xf9, 0x7f, 0x4a, 0xa1, 0xe7, 0xf9,
+  0xd3, 0x1d, 0x16, 0xe9, 0x32, 0xe4, 0xcc, 0x30, 0x7f, 0x99, 0x37, 0x61, 0xa0, 0xec, 0x51, 0x40,
+  0x9c, 0xf8, 0xc5, 0x54, 0xb7, 0xd8, 0x4f, 0xcc, 0x7a, 0xf4, 0x41, 0x96, 0x29, 0x65, 0x71, 0xe2,
+  0x79, 0xa9, 0xaf, 0x6e, 0x99, 0xc4, 0x14, 0x0a, 0x02, 0xc5, 0xa2, 0x60, 0xe9, 0x26, 0x94, 0xc2,
+  0x84, 0x7a, 0x73, 0x3e, 0x31, 0xcc, 0x94, 0x3a, 0xf4, 0xa1, 0xea, 0xb2, 0x07, 0x03, 0x56, 0x88,
+  0x81, 0x76, 0xa6, 0x60, 0xef, 0x2a, 0xba, 0x16, 0x99, 0x32, 0xf3, 0x98, 0xf7, 0xf8, 0x65, 0x2f,
+  0x3b, 0x1d, 0xad, 0x6d, 0x5e, 0x56, 0x5b, 0xd2, 0xb9, 0xc9, 0x52, 0xb2, 0x05, 0x81, 0x3f, 0x4a,
+  0x72, 0x05, 0xa1, 0x3d, 0x97, 0x2c, 0x43, 0x10, 0x74, 0xff, 0x68, 0x26, 0xcc, 0x9a, 0x1f, 0x3c,
+  0xfe, 0x80, 0x1c, 0x4e, 0x75, 0x61, 0x07, 0x20, 0x65, 0x5a, 0x8f, 0xbb, 0x84, 0x09, 0xe0, 0x80,
+  0x12, 0x71, 0xe8, 0x7b, 0xeb, 0xfc, 0x00, 0xe7, 0x10, 0x00, 0xd5, 0x10, 0xa8, 0xb0, 0x41, 0x8f,
+  0xac, 0x41, 0xf7, 0xcc, 0x82, 0x1c, 0x33, 0xfd, 0x3a, 0x1d, 0x58, 0x86, 0xb3, 0x2a, 0xf0, 0xaa,
+  0xce, 0xdf, 0x12, 0x50, 0xea, 0x42, 0x4a, 0x54, 0xef, 0xa7, 0x1f, 0xaf, 0x29, 0x39, 0x1b, 0xd3,
+  0xd5, 0x77, 0xa7, 0x36, 0x95, 0x60, 0x74, 0xc3, 0x44, 0x3c, 0xb6, 0x0a, 0x16, 0x3b, 0xd3, 0xbe,
+  0x60, 0x71, 0x43, 0x30, 0x8e, 0x0b, 0x11, 0xe3, 0x15, 0xdf, 0xd3, 0x2b, 0x8e, 0x6a, 0xd3, 0xc4,
+  0xa8, 0x51, 0x0d, 0x8f, 0xf3, 0x8c, 0xd2, 0x5e, 0x7e, 0xa2, 0x5b, 0xb4, 0x78, 0x34, 0xac, 0x6b,
+  0x8f, 0xa7, 0x5c, 0x7d, 0xfe, 0x98, 0xf3, 0x36, 0x78, 0x6d, 0x5a, 0x63, 0x79, 0x9e, 0xab, 0x16,
+  0x9c, 0xd0, 0x97, 0xd2, 0x28, 0x26, 0x63, 0xb4, 0xaa, 0xba, 0x67, 0xce, 0x9c, 0xb2, 0x13, 0xb7,
+  0x89, 0x82, 0x57, 0x0b, 0x1a, 0x47, 0x0a, 0x53, 0xb6, 0xd4, 0x11, 0x55, 0xf6, 0x92, 0x96, 0xc2,
+  0xce, 0x00, 0xec, 0x55, 0x95, 0x8b, 0xc5, 0xd9, 0x1d, 0xa6, 0x2f, 0x7f, 0x82, 0xad, 0x95, 0x8a,
+  0x64, 0x99, 0xcd, 0x50, 0xd9, 0x7a, 0x41, 0x88, 0xd4, 0x3f, 0x3c, 0xaf, 0x0c, 0xb6, 0x97, 0x5c,
+  0x1d, 0x7b, 0xf6, 0xa0, 0xe2, 0xa9, 0x3f, 0xc1, 0xe9, 0xac, 0x34, 0x86, 0x82, 0xd8, 0x11, 0x38,
+  0x74, 0x19, 0x8c, 0xbb, 0xbb, 0x84, 0x5d, 0x6f, 0x65, 0x2e, 0x9d, 0x71, 0xd7, 0x7e, 0x2f, 0x88,
+  0xb3, 0x7b, 0x76, 0xe1, 0x9e, 0xd4, 0xe9, 0xc0, 0x93, 0x9c, 0xfd, 0x0b, 0x7f, 0xd5, 0x7f, 0x79,
+  0x92, 0x74, 0xbf, 0x25, 0x16, 0xc7, 0x4d, 0xb4, 0x77, 0xa8, 0xd9, 0x4e, 0xc0, 0xd3, 0x81, 0x95,
+  0xa1, 0xee, 0xcc, 0xde, 0xba, 0x3a, 0x5e, 0xca, 0xff, 0xd8, 0x9d, 0x9a, 0x56, 0x4b, 0xf1, 0x8e,
+  0xe9, 0xf9, 0x2c, 0x67, 0x8a, 0x57, 0xed, 0xb9, 0xde, 0xf7, 0x8c, 0xf3, 0xcb, 0x05, 0x3d, 0x5c,
+  0x0b, 0x4d, 0x55, 0x46, 0x45, 0x8d, 0x45, 0xab, 0xef, 0x73, 0xd0, 0x87, 0x4d, 0x81, 0xb0, 0x2e,
+  0x90, 0xad, 0xeb, 0x8c, 0x42, 0x61, 0x64, 0x98, 0xa2, 0x0e, 0xf7, 0x09, 0xb9, 0x7d, 0x1b, 0xd9,
+  0x7b, 0x51, 0x28, 0x5f, 0xe6, 0x4d, 0x45, 0xdd, 0x0a, 0xf7, 0x43, 0xe0, 0x2c, 0xe7, 0x5e, 0x18,
+  0xab, 0xcb, 0x8e, 0x8f, 0x95, 0xe7, 0xfb, 0x4a, 0x98, 0x6d, 0xb3, 0x3f, 0xac, 0x86, 0x67, 0x6b,
+  0xd8, 0x2a, 0x49, 0x56, 0x80, 0xa9, 0xc6, 0x9d, 0x44, 0x68, 0x04, 0x32, 0x26, 0x79, 0x6b, 0x2a,
+  0x95, 0xed, 0xbc, 0xfa, 0x76, 0xf1, 0x50, 0xc6, 0x34, 0x01, 0xbf, 0xde, 0x5d, 0xbd, 0xa5, 0xd9,
+  0xc9, 0x25, 0x69, 0xd2, 0x42, 0x56, 0x25, 0xb1, 0xde, 0xc6, 0xbd, 0xcd, 0xd6, 0xf0, 0xf5, 0xd9,
+  0x59, 0x9e, 0x8d, 0xa3, 0x7a, 0x3d, 0xd8, 0x23, 0xa2, 0x74, 0x6f, 0x08, 0xf4, 0xff, 0x1d, 0x6e,
+  0x79, 0xf4, 0xe1, 0xf8, 0xe8, 0xe8, 0xe8, 0x35, 0x8c, 0xa7, 0xe8, 0xc3, 0x4f, 0x1e, 0x53, 0xed,
+  0xf1, 0x97, 0xaf, 0x8f, 0x42, 0x32, 0xfb, 0xea, 0xe0, 0xd7, 0x4c, 0xa9, 0x58, 0x4c, 0xef, 0x08,
+  0x72, 0xa7, 0x05, 0xbc, 0xf3, 0x2f, 0xb9, 0xca, 0xc2, 0xcd, 0x3f, 0x29, 0x4d, 0x63, 0x46, 0x05,
+  0x75, 0xfb, 0xc4, 0xaf, 0xa8, 0xd1, 0xb7, 0x2f, 0x2f, 0x4b, 0xb2, 0xde, 0x51, 0x11, 0xe5, 0x4b,
+  0xaf, 0x1f, 0xcd, 0xb5, 0x35, 0xda, 0xa0, 0x1a, 0x7b, 0xa9, 0x01, 0xdc, 0xdb, 0x56, 0x0e, 0x5b,
+  0x2f, 0xa5, 0x06, 0x70, 0x7b, 0x4f, 0x39, 0x94, 0xeb, 0x9d, 0xe3, 0xa9, 0xd8, 0x22, 0xf4, 0x03,
+  0x72, 0x7f, 0xf4, 0x10, 0x19, 0x91, 0xed, 0xa1, 0x4f, 0xda, 0xd1, 0xc7, 0x1b, 0xb4, 0xaf, 0xa5,
+  0xf3, 0xd8, 0x1f, 0x10, 0x5d, 0xce, 0x32, 0xfa, 0x9f, 0x69, 0x9d, 0x10, 0x8c, 0xe8, 0x75, 0xcb,
+  0xc2, 0xdf, 0x61, 0xc2, 0xe8, 0x8d, 0x2d, 0xac, 0x1a, 0x64, 0xab, 0xf7, 0x9c, 0x9c, 0xfd, 0x75,
+  0x5f, 0xd6, 0x32, 0x0d, 0xe1, 0xa0, 0x45, 0xc9, 0x7e, 0x85, 0x6a, 0x68, 0x34, 0x7c, 0x45, 0xcb,
+  0x1a, 0x5a, 0xab, 0x54, 0x13, 0x6e, 0x0b, 0x59, 0xa3, 0xfc, 0xad, 0x87, 0x70, 0xbf, 0xde, 0x69,
+  0xcf, 0x7e, 0x4f, 0x0d, 0xe1, 0xb8, 0x0f, 0x56, 0x89, 0xda, 0x7f, 0x57, 0xe2, 0x55, 0x7f, 0xdf,
+  0xe5, 0xa4, 0xc5, 0xa5, 0xa1, 0xf3, 0xaa, 0xf2, 0x78, 0xa8, 0x56, 0x59, 0xdb, 0x18, 0x55, 0x8b,
+  0xcb, 0x4e, 0x71, 0xa3, 0x1f, 0x7b, 0xfb, 0xdd, 0x3b, 0xf2, 0xe3, 0xbe, 0xbb, 0xd8, 0x46, 0x9d,
+  0x7f, 0x00, 0xb7, 0x36, 0xee, 0x1f, 0x79, 0x0b, 0x00, 0x00,
+};
+
+static const WebAsset assetScript = {
+  "/app.js", "application/javascript", assetScriptData, sizeof(assetScriptData), "\"4c5ee635\"", true
+};
+
+// index.html (1219 bytes, 571 comprimido)
+static const uint8_t assetIndexData[] PROGMEM = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x9d, 0x94, 0x4d, 0x6e, 0xdb, 0x30,
+  0x10, 0x85, 0xf7, 0x39, 0x05, 0xcb, 0x95, 0x0b, 0xd4, 0x91, 0x9d, 0xc6, 0x45, 0x52, 0x48, 0x2a,
+  0x02, 0xa7, 0x40, 0xb2, 0xc8, 0x0f, 0xec, 0x2e, 0xd2, 0xe5, 0x88, 0x1c, 0x57, 0x4c, 0x28, 0x51,
+  0x20, 0xc7, 0x4e, 0x7d, 0x9c, 0x2c, 0xbb, 0xee, 0x11, 0x72, 0xb1, 0x0e, 0x25, 0x19, 0x89, 0x1d,
+  0xc0, 0x08, 0xba, 0x22, 0x39, 0x7a, 0xdf, 0x23, 0x39, 0xc3, 0x51, 0xfa, 0xe1, 0xfc, 0x66, 0xfa,
+  0xe3, 0xe7, 0xed, 0x77, 0x51, 0x52, 0x65, 0xf3, 0x83, 0x74, 0x33, 0x20, 0x68, 0x1e, 0x2a, 0x24,
+  0x10, 0xaa, 0x04, 0x1f, 0x90, 0x32, 0xb9, 0xa4, 0xc5, 0xf0, 0x44, 0x6e, 0xc2, 0x35, 0x54, 0x98,
+  0xc9, 0x95, 0xc1, 0xc7, 0xc6, 0x79, 0x92, 0x42, 0xb9, 0x9a, 0xb0, 0x66, 0xd9, 0xa3, 0xd1, 0x54,
+  0x66, 0x1a, 0x57, 0x46, 0xe1, 0xb0, 0x5d, 0x7c, 0x12, 0xa6, 0x36, 0x64, 0xc0, 0x0e, 0x83, 0x02,
+  0x8b, 0xd9, 0x38, 0x9a, 0x90, 0x21, 0x8b, 0xf9, 0x0d, 0x56, 0x67, 0x4a, 0x61, 0x08, 0x69, 0xd2,
+  0x05, 0x0e, 0x52, 0x6b, 0xea, 0x07, 0xe1, 0xd1, 0x66, 0x32, 0xd0, 0xda, 0x62, 0x28, 0x11, 0xd9,
+  0xbe, 0xf4, 0xb8, 0xc8, 0x64, 0x82, 0x81, 0x8c, 0x75, 0xe1, 0x50, 0x85, 0xf0, 0x6d, 0x95, 0x1d,
+  0x9f, 0x14, 0xfa, 0xf4, 0xf4, 0xb8, 0x88, 0x7e, 0x49, 0x7f, 0xe6, 0xc2, 0xe9, 0x35, 0x0f, 0xda,
+  0xac, 0x84, 0xb2, 0x10, 0x42, 0x26, 0xe3, 0xc9, 0xc0, 0xd4, 0xe8, 0x59, 0x26, 0x44, 0x5a, 0x8e,
+  0x5f, 0x76, 0x15, 0x73, 0x13, 0x08, 0x2b, 0x10, 0x1a, 0xc5, 0x94, 0x65, 0xde, 0x59, 0x36, 0x1a,
+  0xe7, 0x07, 0x51, 0xf8, 0xda, 0x02, 0xbc, 0x6e, 0xe9, 0xc8, 0x1f, 0xe5, 0x97, 0xf5, 0xc2, 0xf9,
+  0x0a, 0x94, 0x79, 0xfe, 0x5b, 0x33, 0x6a, 0xc5, 0xb9, 0x09, 0x8d, 0x0b, 0x7c, 0xc7, 0x95, 0x63,
+  0xfe, 0xa8, 0x57, 0x12, 0x14, 0xf1, 0x46, 0x42, 0x74, 0x2b, 0x9f, 0xa7, 0xa4, 0xf3, 0xcb, 0xf3,
+  0xaf, 0x7c, 0x57, 0x1d, 0xe7, 0xc2, 0xe8, 0x4c, 0x76, 0x89, 0xba, 0x64, 0xfb, 0x61, 0x17, 0x4f,
+  0x58, 0xb8, 0xc3, 0x5c, 0xbb, 0xaa, 0xf0, 0xb8, 0xcd, 0x29, 0x57, 0x35, 0x50, 0xaf, 0xaf, 0xb9,
+  0x0c, 0xfb, 0xd0, 0x39, 0x01, 0x2d, 0xc3, 0x36, 0x1a, 0xda, 0xd8, 0x05, 0xfe, 0xde, 0x07, 0x5e,
+  0x39, 0xed, 0x04, 0x79, 0x28, 0xe0, 0xde, 0x6d, 0xe3, 0x8f, 0xce, 0x3f, 0xf0, 0xd7, 0xbd, 0xdb,
+  0xde, 0x2e, 0xd1, 0x13, 0xec, 0xdc, 0xd4, 0x39, 0xff, 0x96, 0xe1, 0xd9, 0x4b, 0x9a, 0xda, 0x9c,
+  0x47, 0x6d, 0x61, 0x28, 0x48, 0x56, 0xf1, 0xba, 0x2d, 0x5a, 0x37, 0xd9, 0x5f, 0x95, 0xbe, 0x80,
+  0xb1, 0x96, 0x33, 0xb4, 0xcf, 0x7f, 0xc2, 0xab, 0x52, 0x6c, 0x7c, 0xf9, 0x5d, 0xc1, 0xfa, 0x3f,
+  0x9c, 0x2b, 0xa8, 0xb5, 0x0b, 0x62, 0xf6, 0xfc, 0xd4, 0x18, 0x9e, 0xbc, 0x72, 0x2e, 0x96, 0x44,
+  0x8e, 0x5f, 0x01, 0x10, 0x0c, 0xb9, 0x26, 0x51, 0x98, 0xc9, 0xf9, 0x48, 0xf6, 0x99, 0x17, 0x83,
+  0xf9, 0xe8, 0x63, 0x9a, 0x74, 0xaa, 0x7d, 0xc8, 0x94, 0xbb, 0xe2, 0x02, 0x0a, 0x63, 0x0d, 0x81,
+  0x17, 0x73, 0x05, 0x35, 0xbf, 0x58, 0x31, 0x98, 0x8e, 0xdf, 0x47, 0x4f, 0x64, 0x7e, 0xa6, 0xf8,
+  0xfd, 0x31, 0x7b, 0xe5, 0xb8, 0x85, 0x90, 0x90, 0xe1, 0xc9, 0xbb, 0xe0, 0xbb, 0x91, 0xdc, 0x5c,
+  0xdc, 0x2d, 0x16, 0x32, 0x9f, 0x21, 0xf7, 0xab, 0x32, 0x6c, 0x35, 0xb8, 0x7b, 0x73, 0xf8, 0xc6,
+  0x63, 0x9f, 0xc9, 0xc6, 0xae, 0x63, 0x22, 0x39, 0xb0, 0x93, 0xc8, 0x26, 0x4f, 0x61, 0xd3, 0xb0,
+  0xdc, 0x7c, 0x0b, 0xf3, 0x4b, 0xc6, 0xe2, 0xf0, 0xb8, 0xf4, 0x5d, 0xd3, 0xa4, 0x09, 0x44, 0x32,
+  0xb6, 0x6d, 0x4b, 0xa5, 0x41, 0x79, 0xd3, 0x90, 0x08, 0x5e, 0x31, 0x03, 0x4d, 0x73, 0x78, 0xdf,
+  0xf6, 0xb7, 0x9a, 0x20, 0x7e, 0xf9, 0x3c, 0x89, 0xdb, 0x74, 0x8a, 0x48, 0xf4, 0x1d, 0x9e, 0x74,
+  0xff, 0xaa, 0x7f, 0x78, 0xad, 0x47, 0xcc, 0xc3, 0x04, 0x00, 0x00,
+};
+
+static const WebAsset assetIndex = {
+  "/", "text/html", assetIndexData, sizeof(assetIndexData), "\"72e81210\"", false
+};
+
+// config.html (1273 bytes, 572 comprimido)
+static const uint8_t assetConfigPageData[] PROGMEM = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xa5, 0x54, 0xd1, 0x4e, 0xdb, 0x30,
+  0x14, 0x7d, 0xef, 0x57, 0x78, 0x7e, 0x62, 0xd2, 0x4a, 0x48, 0x06, 0x88, 0x4c, 0x49, 0xa6, 0x89,
+  0x22, 0xc4, 0xc3, 0x60, 0x9a, 0xaa, 0x49, 0x7b, 0x74, 0x9c, 0xdb, 0xc6, 0xe0, 0xd8, 0x91, 0xed,
+  0xa4, 0xf4, 0x93, 0xf6, 0xbc, 0x4f, 0xe0, 0xc7, 0x76, 0xed, 0xa4, 0xa5, 0x54, 0x15, 0x08, 0xed,
+  0x25, 0xce, 0xb5, 0xcf, 0x39, 0xf7, 0xf8, 0xda, 0xd7, 0xd9, 0x87, 0xd9, 0xdd, 0xe5, 0xfc, 0xf7,
+  0x8f, 0x2b, 0x52, 0xbb, 0x46, 0x16, 0x93, 0x6c, 0x33, 0x00, 0xab, 0x70, 0x68, 0xc0, 0x31, 0xc2,
+  0x6b, 0x66, 0x2c, 0xb8, 0x9c, 0x76, 0x6e, 0x31, 0xbd, 0xa0, 0x9b, 0x69, 0xc5, 0x1a, 0xc8, 0x69,
+  0x2f, 0x60, 0xd5, 0x6a, 0xe3, 0x28, 0xe1, 0x5a, 0x39, 0x50, 0x08, 0x5b, 0x89, 0xca, 0xd5, 0x79,
+  0x05, 0xbd, 0xe0, 0x30, 0x0d, 0xc1, 0x27, 0x22, 0x94, 0x70, 0x82, 0xc9, 0xa9, 0xe5, 0x4c, 0x42,
+  0x1e, 0x7b, 0x11, 0x27, 0x9c, 0x84, 0xe2, 0x52, 0xab, 0x85, 0x58, 0x76, 0x86, 0x71, 0xf1, 0xf4,
+  0x57, 0x91, 0x3b, 0x68, 0xbe, 0x71, 0x0e, 0xd6, 0x66, 0xd1, 0xb0, 0x3e, 0xc9, 0xa4, 0x50, 0x0f,
+  0xc4, 0x80, 0xcc, 0xa9, 0x75, 0x6b, 0x09, 0xb6, 0x06, 0xc0, 0x6c, 0xb5, 0x81, 0x45, 0x4e, 0x23,
+  0xb0, 0x4e, 0x48, 0x6d, 0x8f, 0xb9, 0xb5, 0x5f, 0xfb, 0xfc, 0xf4, 0xa2, 0xac, 0xd2, 0xf4, 0xb4,
+  0xf4, 0xf2, 0xd1, 0xb8, 0x85, 0x52, 0x57, 0x6b, 0x1c, 0x2a, 0xd1, 0x13, 0x2e, 0x99, 0xb5, 0x39,
+  0xf5, 0x46, 0x99, 0x50, 0x60, 0x10, 0x46, 0x48, 0x56, 0xc7, 0xaf, 0x98, 0xc0, 0xc5, 0x89, 0x07,
+  0xed, 0xd2, 0x99, 0xa9, 0x02, 0xd3, 0x73, 0x93, 0x7d, 0xee, 0x35, 0xa0, 0x30, 0x93, 0xc8, 0x4c,
+  0x46, 0xcc, 0x42, 0x9b, 0x86, 0x88, 0x2a, 0xe4, 0x45, 0xe4, 0x48, 0xc5, 0x05, 0xc9, 0x4a, 0x90,
+  0x04, 0x97, 0x73, 0x3a, 0x14, 0xeb, 0x06, 0x75, 0x6f, 0x66, 0xa4, 0xc2, 0xd9, 0x99, 0xb0, 0xad,
+  0xb6, 0x58, 0xb3, 0x5e, 0x93, 0xa3, 0x93, 0x69, 0x9a, 0x7e, 0xfc, 0x92, 0x45, 0x81, 0xb0, 0xa5,
+  0x0b, 0xd5, 0x76, 0x8e, 0xb8, 0x75, 0x8b, 0xa7, 0xa0, 0xba, 0xa6, 0xc4, 0xfd, 0x8c, 0x67, 0xb2,
+  0x55, 0x0b, 0x69, 0x9f, 0xa3, 0x46, 0xa8, 0x9c, 0x9e, 0xe0, 0xc8, 0x1e, 0x73, 0x9a, 0xa6, 0x34,
+  0x6c, 0x6d, 0xdf, 0x0a, 0xd7, 0x4d, 0xcb, 0xd4, 0xfa, 0x16, 0x95, 0x68, 0x71, 0xab, 0x9b, 0xd2,
+  0x00, 0x3a, 0x22, 0x57, 0x4d, 0x6b, 0xc0, 0xb2, 0x57, 0x5d, 0x38, 0x78, 0x74, 0x1b, 0x0f, 0xbb,
+  0x32, 0xe3, 0xee, 0x77, 0x26, 0xd0, 0x81, 0x04, 0xb5, 0xc4, 0x6b, 0x42, 0xe3, 0xf3, 0xc3, 0x3e,
+  0x56, 0xda, 0x3c, 0x7c, 0xd7, 0x15, 0x9a, 0xc0, 0xaf, 0xf6, 0x16, 0xe6, 0x86, 0x95, 0xec, 0x5e,
+  0xbf, 0xa3, 0x10, 0x5b, 0x8d, 0xe0, 0xe0, 0x39, 0x7a, 0x59, 0x88, 0xc3, 0xf9, 0xf1, 0xc6, 0xb1,
+  0x75, 0x3c, 0x17, 0xbe, 0x0c, 0x73, 0x01, 0x4d, 0xab, 0xc9, 0x4f, 0x90, 0x4f, 0x7f, 0x48, 0x4c,
+  0x8e, 0x2c, 0x2c, 0x3b, 0x55, 0x69, 0xfb, 0x9e, 0x43, 0xd9, 0xd1, 0x0b, 0x6e, 0x76, 0xe3, 0xe0,
+  0x27, 0x7e, 0xe3, 0x60, 0x02, 0x21, 0x39, 0x60, 0x28, 0xf9, 0x0f, 0x43, 0xc9, 0x9e, 0xa1, 0xe4,
+  0x2d, 0x43, 0x65, 0xe7, 0x9c, 0x56, 0xa3, 0xa0, 0xed, 0xca, 0x46, 0x38, 0x5a, 0x5c, 0x77, 0xd8,
+  0x13, 0xcc, 0x90, 0x97, 0xbd, 0x90, 0x45, 0x03, 0x78, 0xec, 0x83, 0xc8, 0x37, 0xc2, 0xf8, 0x8f,
+  0x77, 0x69, 0xcc, 0xd9, 0xca, 0x35, 0x2d, 0xb2, 0x08, 0x27, 0x42, 0x33, 0x46, 0xd8, 0x68, 0x43,
+  0xc7, 0xb5, 0x45, 0xc6, 0x36, 0x5d, 0x4e, 0x8b, 0x5f, 0x5a, 0xf6, 0x60, 0xb2, 0x88, 0x79, 0xac,
+  0xef, 0xee, 0x80, 0xcb, 0x2c, 0x37, 0xa2, 0x75, 0xc4, 0x1a, 0x8e, 0x28, 0xd6, 0xb6, 0xc7, 0xf7,
+  0xe1, 0x19, 0xe0, 0x67, 0x00, 0xe7, 0x9f, 0xcf, 0xbc, 0xf0, 0x80, 0xf0, 0x8c, 0xf1, 0x21, 0x88,
+  0x86, 0x17, 0xee, 0x1f, 0x0a, 0xb1, 0x7f, 0x1e, 0xf9, 0x04, 0x00, 0x00,
+};
+
+static const WebAsset assetConfigPage = {
+  "/config", "text/html", assetConfigPageData, sizeof(assetConfigPageData), "\"b9b6326c\"", false
+};
+
+#endif